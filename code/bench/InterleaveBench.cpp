@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <VertexInterleave.h>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t vertexCount = argc > 1 ? stoul(argv[1]) : 1000000;
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 20;
+
+    const vector<size_t> lengths{3, 2, 3, 4};
+    size_t stride{};
+    vector<vector<float>> sources;
+    vector<VertexInterleave::Stream> streams;
+    mt19937 rng(1);
+    uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (size_t length : lengths) {
+        sources.emplace_back(vertexCount * length);
+        generate(sources.back().begin(), sources.back().end(), [&] { return dist(rng); });
+        stride += length;
+    }
+    size_t offset{};
+    for (size_t i = 0; i < lengths.size(); i++) {
+        streams.push_back({sources[i].data(), lengths[i] * sizeof(float), offset * sizeof(float)});
+        offset += lengths[i];
+    }
+    vector<unsigned int> indices(vertexCount * lengths.size());
+    for (auto& index : indices) {
+        index = static_cast<unsigned int>(rng() % vertexCount);
+    }
+
+    vector<float> reference(vertexCount * stride);
+    vector<float> out(vertexCount * stride);
+    auto measure = [rounds](const auto& func) {
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; i++) func();
+        return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    };
+    auto naive = [&](bool isIndexed) {
+        for (size_t v = 0; v < vertexCount; v++) {
+            for (size_t s = 0; s < lengths.size(); s++) {
+                size_t source = isIndexed ? indices[v * lengths.size() + s] : v;
+                memcpy(reference.data() + v * stride + streams[s].offset / sizeof(float),
+                    sources[s].data() + source * lengths[s], streams[s].size);
+            }
+        }
+    };
+
+    double naiveSeconds = measure([&] { naive(false); });
+    double sequentialSeconds = measure([&] {
+        VertexInterleave::interleave(out.data(), stride * sizeof(float), streams.data(), streams.size(), vertexCount);
+    });
+    if (out != reference) {
+        cerr << "顺序交错结果不一致" << endl;
+        return 1;
+    }
+    double naiveIndexedSeconds = measure([&] { naive(true); });
+    double indexedSeconds = measure([&] {
+        VertexInterleave::interleave(out.data(), stride * sizeof(float), streams.data(), streams.size(), indices.data(), vertexCount);
+    });
+    if (out != reference) {
+        cerr << "索引交错结果不一致" << endl;
+        return 1;
+    }
+
+    auto throughput = [&](double seconds) {
+        return static_cast<double>(out.size() * sizeof(float)) * static_cast<double>(rounds) / seconds / (1024.0 * 1024.0 * 1024.0);
+    };
+    cout << "顶点: " << vertexCount << ", 顶点字节数: " << stride * sizeof(float) << endl;
+    cout << fixed << setprecision(2)
+         << "顺序: " << throughput(naiveSeconds) << " -> " << throughput(sequentialSeconds) << " GiB/s" << endl
+         << "索引: " << throughput(naiveIndexedSeconds) << " -> " << throughput(indexedSeconds) << " GiB/s" << endl;
+    return 0;
+}
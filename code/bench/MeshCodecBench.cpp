@@ -0,0 +1,66 @@
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <MeshCodec.h>
+#include <ModelParser.h>
+
+using namespace std;
+namespace fs = filesystem;
+
+int main(int argc, char** argv) {
+    fs::path path = argc > 1 ? argv[1] : "resource/model/model.obj";
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 100;
+
+    auto models = ModelParser::ObjModelCacheLoader(path);
+
+    size_t vertexBytes{}, encodedVertexBytes{}, indexBytes{}, encodedIndexBytes{};
+    double vertexSeconds{}, indexSeconds{};
+    for (auto& [name, layout] : models) {
+        const vector<float>& vertices = layout.assembled();
+        const vector<unsigned int>& indices = layout.bufferOfIndices();
+        const size_t vertexSize = layout.elements()[0].step;
+        const size_t vertexCount = vertices.size() * sizeof(float) / vertexSize;
+
+        vector<unsigned char> encodedVertices = MeshCodec::encodeVertices(vertices.data(), vertexCount, vertexSize);
+        vector<unsigned char> encodedIndices = MeshCodec::encodeIndices(indices.data(), indices.size());
+        vector<float> decodedVertices(vertices.size());
+        vector<unsigned int> decodedIndices(indices.size());
+
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; i++) {
+            (void) MeshCodec::decodeVertices(decodedVertices.data(), vertexCount, vertexSize, encodedVertices.data(), encodedVertices.size());
+        }
+        vertexSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; i++) {
+            (void) MeshCodec::decodeIndices(decodedIndices.data(), indices.size(), encodedIndices.data(), encodedIndices.size());
+        }
+        indexSeconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+        if (decodedVertices != vertices || decodedIndices != indices) {
+            cerr << name << ": 解码结果不一致" << endl;
+            return 1;
+        }
+        vertexBytes += vertices.size() * sizeof(float);
+        encodedVertexBytes += encodedVertices.size();
+        indexBytes += indices.size() * sizeof(unsigned int);
+        encodedIndexBytes += encodedIndices.size();
+    }
+
+    auto throughput = [rounds](size_t bytes, double seconds) {
+        return static_cast<double>(bytes) * static_cast<double>(rounds) / seconds / (1024.0 * 1024.0 * 1024.0);
+    };
+    cout << "模型: " << path.string() << endl;
+    cout << fixed << setprecision(2)
+         << "顶点: " << vertexBytes << " -> " << encodedVertexBytes << " 字节 ("
+         << 100.0 * static_cast<double>(encodedVertexBytes) / static_cast<double>(vertexBytes) << "%), 解码 "
+         << throughput(vertexBytes, vertexSeconds) << " GiB/s" << endl
+         << "索引: " << indexBytes << " -> " << encodedIndexBytes << " 字节 ("
+         << 100.0 * static_cast<double>(encodedIndexBytes) / static_cast<double>(indexBytes) << "%), 解码 "
+         << throughput(indexBytes, indexSeconds) << " GiB/s" << endl;
+    return 0;
+}
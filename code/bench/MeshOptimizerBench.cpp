@@ -0,0 +1,66 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <MeshOptimizer.h>
+#include <ModelParser.h>
+
+using namespace std;
+namespace fs = filesystem;
+
+/**
+ * @brief 累计的ACMR统计
+ * @details 以三角形数加权, 使各对象按其面数贡献
+ */
+struct AcmrTotal {
+    double weighted{};
+    size_t triangles{};
+
+    void add(double acmr, size_t triangleCount) {
+        weighted += acmr * static_cast<double>(triangleCount);
+        triangles += triangleCount;
+    }
+
+    [[nodiscard]] double value() const {
+        return triangles == 0 ? 0.0 : weighted / static_cast<double>(triangles);
+    }
+};
+
+int main(int argc, char** argv) {
+    fs::path path = argc > 1 ? argv[1] : "resource/model/model.obj";
+    size_t cacheSize = argc > 2 ? stoul(argv[2]) : MeshOptimizer::defaultCacheSize;
+
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        cerr << "文件无法打开: " << path.string() << endl;
+        return 1;
+    }
+    string source{istreambuf_iterator<char>(file), istreambuf_iterator<char>()};
+    auto models = ModelParser::ObjModelLoader(source);
+
+    AcmrTotal before{}, after{};
+    for (auto& [name, layout] : models) {
+        size_t stride = layout.elements()[0].step / sizeof(float);
+        size_t vertexCount = layout.WeldIndices().size() / stride;
+        before.add(MeshOptimizer::acmr(layout.bufferOfIndices(), vertexCount, cacheSize), layout.bufferOfIndices().size() / 3);
+    }
+
+    auto begin = chrono::steady_clock::now();
+    MeshOptimizer::optimize(models, cacheSize);
+    chrono::duration<double> seconds = chrono::steady_clock::now() - begin;
+
+    for (auto& [name, layout] : models) {
+        size_t stride = layout.elements()[0].step / sizeof(float);
+        size_t vertexCount = layout.WeldIndices().size() / stride;
+        after.add(MeshOptimizer::acmr(layout.bufferOfIndices(), vertexCount, cacheSize), layout.bufferOfIndices().size() / 3);
+    }
+
+    cout << "模型: " << path.string() << ", 三角形: " << before.triangles << ", 缓存大小: " << cacheSize << endl;
+    cout << fixed << setprecision(3)
+         << "ACMR: " << before.value() << " -> " << after.value() << endl
+         << "优化耗时: " << seconds.count() * 1000.0 << "ms" << endl;
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ModelParser.h>
+
+using namespace std;
+namespace fs = filesystem;
+
+/**
+ * @brief 对解析器进行吞吐量测试
+ * @details 先预热一轮, 之后取多轮平均吞吐量
+ * @tparam Parser 解析器调用类型
+ * @param name 解析器名称
+ * @param source obj模型源
+ * @param rounds 测试轮数
+ * @param parser 解析器调用
+ * @return 吞吐量[MiB/s]
+ */
+template<typename Parser>
+double bench(const string& name, const string& source, size_t rounds, Parser&& parser) {
+    (void) parser(source);
+    auto begin = chrono::steady_clock::now();
+    for (size_t i = 0; i < rounds; i++) {
+        auto models = parser(source);
+        if (models.empty()) {
+            cerr << name << ": 解析结果为空" << endl;
+        }
+    }
+    chrono::duration<double> seconds = chrono::steady_clock::now() - begin;
+    double throughput = static_cast<double>(source.size()) * static_cast<double>(rounds) / seconds.count() / (1024.0 * 1024.0);
+    cout << left << setw(10) << name
+         << fixed << setprecision(2)
+         << setw(12) << seconds.count() * 1000.0 / static_cast<double>(rounds) << "ms/次  "
+         << throughput << " MiB/s" << endl;
+    return throughput;
+}
+
+/**
+ * @brief 校验两种解析器输出一致
+ * @details 他似乎不需要详细注释[划掉]
+ */
+bool verify(const string& source) {
+    auto expected = ModelParser::ObjModelLegacyLoader(source);
+    auto actual = ModelParser::ObjModelLoader(source);
+    if (expected.size() != actual.size()) return false;
+    for (auto& [name, layout] : expected) {
+        auto it = actual.find(name);
+        if (it == actual.end()) return false;
+        if (layout.ExpandIndices() != it->second.ExpandIndices()) return false;
+        if (layout.bufferOfIndices() != it->second.bufferOfIndices()) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    fs::path path = argc > 1 ? argv[1] : "resource/model/model.obj";
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 20;
+
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        cerr << "文件无法打开: " << path.string() << endl;
+        return 1;
+    }
+    string source{istreambuf_iterator<char>(file), istreambuf_iterator<char>()};
+
+    cout << "模型: " << path.string() << " (" << source.size() / 1024 << " KiB), 轮数: " << rounds << endl;
+    if (!verify(source)) {
+        cerr << "错误: 新旧解析器输出不一致" << endl;
+        return 1;
+    }
+
+    size_t corners{}, vertices{};
+    for (auto& [name, layout] : ModelParser::ObjModelLoader(source)) {
+        (void) layout.WeldIndices();
+        corners += layout.weldStatistics().corners;
+        vertices += layout.weldStatistics().vertices;
+    }
+    cout << "顶点焊接: " << corners << " -> " << vertices << " ("
+         << fixed << setprecision(1) << static_cast<double>(vertices) * 100.0 / static_cast<double>(corners) << "%)" << endl;
+
+    double legacy = bench("legacy", source, rounds, [](const string& s) { return ModelParser::ObjModelLegacyLoader(s); });
+    double serial = bench("serial", source, rounds, [](const string& s) { return ModelParser::ObjModelLoader(s, false); });
+    double parallel = bench("parallel", source, rounds, [](const string& s) { return ModelParser::ObjModelLoader(s, true); });
+    double stream = bench("stream", source, rounds, [](const string& s) {
+        map<string, VertexLayout<float>> models{};
+        istringstream in(s);
+        ModelParser::ObjModelStreamLoader(in, [&models](string name, VertexLayout<float> layout) {
+            models.emplace(std::move(name), std::move(layout));
+        }, 64 * 1024);
+        return models;
+    });
+    cout << "加速比: " << fixed << setprecision(2)
+         << "serial " << serial / legacy << "x, parallel " << parallel / legacy << "x, stream " << stream / legacy << "x" << endl;
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <RenderQueue.h>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t drawCount = argc > 1 ? stoul(argv[1]) : 100000;
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 100;
+
+    mt19937 rng(1);
+    uniform_real_distribution<float> dist(0.1f, 1000.0f);
+    vector<uint64_t> keys(drawCount);
+    for (auto& key : keys) {
+        const auto pass = rng() % 8 == 0 ? RenderQueue::Pass::Transparent : RenderQueue::Pass::Opaque;
+        key = RenderQueue::key(pass, rng() % 16, rng() % 64, rng() % 4, dist(rng));
+    }
+
+    RenderQueue queue;
+    vector<RenderQueue::Entry> reference;
+    auto measure = [rounds](const auto& func) {
+        auto begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; i++) func();
+        return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    };
+
+    double comparisonSeconds = measure([&] {
+        reference.clear();
+        for (size_t i = 0; i < keys.size(); i++) {
+            reference.push_back({keys[i], static_cast<uint32_t>(i)});
+        }
+        stable_sort(reference.begin(), reference.end(), [](const RenderQueue::Entry& a, const RenderQueue::Entry& b) {
+            return a.key < b.key;
+        });
+    });
+    double radixSeconds = measure([&] {
+        queue.clear();
+        for (size_t i = 0; i < keys.size(); i++) {
+            queue.push(keys[i], static_cast<uint32_t>(i));
+        }
+        queue.sort();
+    });
+    for (size_t i = 0; i < drawCount; i++) {
+        if (queue.entries()[i].key != reference[i].key || queue.entries()[i].item != reference[i].item) {
+            cerr << "排序结果不一致" << endl;
+            return 1;
+        }
+    }
+
+    auto perSecond = [&](double seconds) {
+        return static_cast<double>(drawCount) * static_cast<double>(rounds) / seconds / 1000000.0;
+    };
+    cout << "绘制: " << drawCount << endl;
+    cout << fixed << setprecision(2)
+         << "stable_sort: " << perSecond(comparisonSeconds) << " M/s" << endl
+         << "基数排序: " << perSecond(radixSeconds) << " M/s" << endl;
+    return 0;
+}
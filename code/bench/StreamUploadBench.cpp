@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <VertexLayout.hpp>
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief 以内存模拟的缓冲区对象
+     * @details 替换glad的函数指针, 无需上下文即可检查上传结果与统计上传字节数
+     */
+    struct BufferEmulation {
+        map<GLuint, vector<unsigned char>> buffers;
+        GLuint bound{};
+        size_t uploadedBytes{};
+        size_t calls{};
+    };
+
+    BufferEmulation emulation;
+
+    void APIENTRY bindBuffer(GLenum, GLuint buffer) {
+        emulation.bound = buffer;
+    }
+
+    void APIENTRY bufferData(GLenum, GLsizeiptr size, const void* data, GLenum) {
+        auto& buffer = emulation.buffers[emulation.bound];
+        buffer.assign(static_cast<size_t>(size), 0);
+        if (data != nullptr) memcpy(buffer.data(), data, buffer.size());
+    }
+
+    void APIENTRY bufferSubData(GLenum, GLintptr offset, GLsizeiptr size, const void* data) {
+        memcpy(emulation.buffers[emulation.bound].data() + offset, data, static_cast<size_t>(size));
+        emulation.uploadedBytes += static_cast<size_t>(size);
+        emulation.calls++;
+    }
+
+    void* APIENTRY mapBufferRange(GLenum, GLintptr offset, GLsizeiptr size, GLbitfield) {
+        emulation.uploadedBytes += static_cast<size_t>(size);
+        emulation.calls++;
+        return emulation.buffers[emulation.bound].data() + offset;
+    }
+
+    GLboolean APIENTRY unmapBuffer(GLenum) {
+        return GL_TRUE;
+    }
+
+    /**
+     * @brief 构建坐标, 纹理坐标与法线交错的布局
+     * @details 存储格式与Model::storageFormatInit对纹理坐标落在[0, 1]的模型的选择一致
+     * @param vertexCount 顶点数量
+     * @param rng 随机数引擎
+     * @return 缓冲区组装布局
+     */
+    VertexLayout<float> layoutBuild(size_t vertexCount, mt19937& rng) {
+        uniform_real_distribution<float> dist(0.0f, 1.0f);
+        vector<float> buffer(vertexCount * 8);
+        for (size_t v = 0; v < vertexCount; v++) {
+            for (size_t k = 0; k < 8; k++) buffer[v * 8 + k] = dist(rng);
+            const float length = sqrt(buffer[v * 8 + 5] * buffer[v * 8 + 5] + buffer[v * 8 + 6] * buffer[v * 8 + 6] + buffer[v * 8 + 7] * buffer[v * 8 + 7]);
+            for (size_t k = 5; k < 8; k++) buffer[v * 8 + k] /= length;
+        }
+        vector<unsigned int> indices(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) indices[i] = static_cast<unsigned int>(i);
+        VertexLayout<float> layout = VertexLayout<float>::builder()
+            .appendElement("vertices", 3)
+            .appendElement("texCoord", 2)
+            .appendElement("normal", 3)
+            .attachAssembled(std::move(buffer), std::move(indices))
+            .build();
+        layout.storageFormat("vertices", StorageFormat::Half);
+        layout.storageFormat("texCoord", StorageFormat::Unorm16);
+        layout.storageFormat("normal", StorageFormat::Octahedral);
+        return layout;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t vertexCount = argc > 1 ? stoul(argv[1]) : 100000;
+    size_t rounds = argc > 2 ? stoul(argv[2]) : 100;
+    size_t updateCount = argc > 3 ? stoul(argv[3]) : 8;
+
+    glad_glBindBuffer = bindBuffer;
+    glad_glBufferData = bufferData;
+    glad_glBufferSubData = bufferSubData;
+    glad_glMapBufferRange = mapBufferRange;
+    glad_glUnmapBuffer = unmapBuffer;
+
+    mt19937 layoutRng(1);
+    VertexLayout<float> interleaved = layoutBuild(vertexCount, layoutRng);
+    layoutRng.seed(1);
+    VertexLayout<float> separate = layoutBuild(vertexCount, layoutRng);
+    separate.streamMode(StreamMode::Separate);
+    const size_t elementCount = separate.elements().size();
+
+    // 整体上传: Interleaved写入缓冲区0, Separate的元素i写入缓冲区i + 1
+    bindBuffer(GL_ARRAY_BUFFER, 0);
+    vector<unsigned char> data = interleaved.packBuffer();
+    bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.size()), data.data(), GL_STATIC_DRAW);
+    for (size_t i = 0; i < elementCount; i++) {
+        bindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(i + 1));
+        data = separate.packStream(i);
+        bufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(data.size()), data.data(), GL_STATIC_DRAW);
+    }
+
+    // 每轮以相同的随机修改变形两个布局的坐标, 只有坐标的顶点流应被写入
+    mt19937 rng(2);
+    uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    const size_t span = (std::max)(vertexCount / 1000, size_t{1});
+    vector<vector<float>> updates(updateCount, vector<float>(span * 3));
+    vector<size_t> firsts(updateCount);
+    auto measure = [&](VertexLayout<float>& layout, const auto& upload) {
+        rng.seed(2);
+        emulation.uploadedBytes = 0;
+        emulation.calls = 0;
+        double seconds{};
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t u = 0; u < updateCount; u++) {
+                firsts[u] = rng() % (vertexCount - span + 1);
+                for (auto& value : updates[u]) value = dist(rng);
+            }
+            auto begin = chrono::steady_clock::now();
+            for (size_t u = 0; u < updateCount; u++) {
+                layout.updateAssembled("vertices", firsts[u], updates[u]);
+            }
+            upload();
+            seconds += chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        }
+        return seconds;
+    };
+
+    double interleavedSeconds = measure(interleaved, [&] {
+        bindBuffer(GL_ARRAY_BUFFER, 0);
+        interleaved.bufferSubData(GL_ARRAY_BUFFER);
+    });
+    const size_t interleavedBytes = emulation.uploadedBytes;
+    double separateSeconds = measure(separate, [&] {
+        for (size_t i = 0; i < elementCount; i++) {
+            if (separate.uploadRanges(i).empty()) continue;
+            if (i != 0) {
+                cerr << "未修改的元素" << separate.elements()[i].identifier << "有等待上传的区间" << endl;
+                exit(1);
+            }
+            bindBuffer(GL_ARRAY_BUFFER, static_cast<GLuint>(i + 1));
+            separate.streamSubData(i, GL_ARRAY_BUFFER);
+        }
+    });
+    const size_t separateBytes = emulation.uploadedBytes;
+    const size_t separateCalls = emulation.calls;
+
+    if (interleaved.isUploadPending() || separate.isUploadPending()) {
+        cerr << "上传后仍有等待上传的区间" << endl;
+        return 1;
+    }
+    if (emulation.buffers[0] != interleaved.packBuffer()) {
+        cerr << "Interleaved局部上传结果不一致" << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < elementCount; i++) {
+        if (emulation.buffers[static_cast<GLuint>(i + 1)] != separate.packStream(i)) {
+            cerr << "Separate局部上传结果不一致: " << separate.elements()[i].identifier << endl;
+            return 1;
+        }
+    }
+    if (separate.assembled() != interleaved.assembled()) {
+        cerr << "两种模式的组装缓冲区不一致" << endl;
+        return 1;
+    }
+
+    cout << "顶点: " << vertexCount << ", 每轮修改: " << updateCount << " x " << span << "个顶点的坐标, 轮数: " << rounds << endl;
+    cout << fixed << setprecision(2)
+         << "Interleaved: " << static_cast<double>(interleavedBytes) / rounds / 1024.0 << " KiB/轮, " << interleavedSeconds * 1000.0 << "ms" << endl
+         << "Separate: " << static_cast<double>(separateBytes) / rounds / 1024.0 << " KiB/轮 (" << separateCalls << "次映射), " << separateSeconds * 1000.0 << "ms" << endl;
+    return 0;
+}
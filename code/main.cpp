@@ -10,7 +10,11 @@
 #include <GLFW/glfw3.h>
 
 #include <TestRenderCode.h>
+#include <GeometryStore.h>
 #include <GlobalLogger.hpp>
+#include <ProgramBinary.h>
+#include <ShaderCache.h>
+#include <VertexArrayCache.h>
 #include <Resource.hpp>
 #include <ResourceTypes.hpp>
 
@@ -31,6 +35,9 @@ void render() {
         glog.log(DefaultLevel::Error, "glad初始化失败");
         return;
     }
+    VertexArrayCache::shared().load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+    GeometryStore::shared().load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
+    ProgramBinary::shared().load(reinterpret_cast<GLADloadproc>(glfwGetProcAddress), "cache/program");
 
     arm.load<Texture>("texture.default", "resource/texture/texture.jpg");
 
@@ -48,6 +55,9 @@ void render() {
         test.render(deltaTime);
         glfwSwapBuffers(window);
     }
+    ShaderCache::shared().clear();
+    GeometryStore::shared().clear();
+    VertexArrayCache::shared().clear();
     glog.log<DefaultLevel::Info>("渲染线程已结束");
 }
 
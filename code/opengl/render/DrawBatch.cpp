@@ -0,0 +1,116 @@
+#include "DrawBatch.h"
+
+#include <cstdint>
+
+#include <GLState.h>
+
+using namespace std;
+
+size_t DrawBatch::transform(const glm::mat4& transform) {
+    _transforms.push_back(transform);
+    return _transforms.size() - 1;
+}
+
+void DrawBatch::draw(GLuint program, GLuint texture, const GeometryStore::Allocation& allocation, size_t firstIndex, size_t indexCount,
+    size_t transform, float depth, RenderQueue::Pass pass) {
+    if (!allocation.isValid() || indexCount == 0) return;
+    const uint64_t key = RenderQueue::key(pass, _queue.programSlot(program), _queue.textureSlot(texture), static_cast<uint32_t>(allocation.pool), depth);
+    _queue.push(key, static_cast<uint32_t>(_draws.size()));
+    _draws.push_back({
+        program,
+        texture,
+        allocation.pool,
+        static_cast<GLuint>(indexCount),
+        static_cast<GLuint>(allocation.firstIndex + firstIndex),
+        static_cast<GLint>(allocation.firstVertex),
+        static_cast<GLuint>(transform)
+    });
+}
+
+void DrawBatch::submit(GeometryStore& store) {
+    _calls = 0;
+    _submitted = _draws.size();
+    if (!_draws.empty()) {
+        _queue.sort();
+        _sorted.clear();
+        for (const RenderQueue::Entry& e : _queue.entries()) {
+            _sorted.push_back(_draws[e.item]);
+        }
+        if (store.isIndirect()) {
+            submitIndirect(store);
+        } else {
+            submitDirect(store);
+        }
+    }
+    _queue.clear();
+    _draws.clear();
+    _transforms.clear();
+}
+
+size_t DrawBatch::calls() const {
+    return _calls;
+}
+
+size_t DrawBatch::draws() const {
+    return _submitted;
+}
+
+bool DrawBatch::isSameGroup(const Draw& a, const Draw& b) {
+    return a.program == b.program && a.texture == b.texture && a.pool == b.pool;
+}
+
+void DrawBatch::bindGroup(GeometryStore& store, const Draw& d) {
+    GLState& state = GLState::shared();
+    state.useProgram(d.program);
+    state.bindTexture(0, GL_TEXTURE_2D, d.texture);
+    store.bind(d.pool);
+}
+
+void DrawBatch::submitIndirect(GeometryStore& store) {
+    store.uploadTransforms(_transforms.data(), _transforms.size());
+    _commands.clear();
+    for (const Draw& d : _sorted) {
+        _commands.push_back({d.count, 1, d.firstIndex, d.baseVertex, d.transform});
+    }
+    store.uploadCommands(_commands.data(), _commands.size());
+
+    for (size_t begin = 0; begin < _sorted.size();) {
+        size_t end = begin + 1;
+        while (end < _sorted.size() && isSameGroup(_sorted[begin], _sorted[end])) end++;
+        bindGroup(store, _sorted[begin]);
+        store.drawIndirect(_sorted[begin].pool, begin, end - begin);
+        _calls++;
+        begin = end;
+    }
+}
+
+void DrawBatch::submitDirect(GeometryStore& store) {
+    for (size_t begin = 0; begin < _sorted.size();) {
+        size_t end = begin + 1;
+        while (end < _sorted.size() && isSameGroup(_sorted[begin], _sorted[end])) end++;
+        bindGroup(store, _sorted[begin]);
+        const GLenum type = store.indexType(_sorted[begin].pool);
+        const size_t indexSize = type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        // 变换无法按绘制区分, 使用同一变换的连续绘制合并为一次调用
+        for (size_t run = begin; run < end;) {
+            const GLuint transform = _sorted[run].transform;
+            _counts.clear();
+            _offsets.clear();
+            _baseVertices.clear();
+            for (; run < end && _sorted[run].transform == transform; run++) {
+                _counts.push_back(static_cast<GLsizei>(_sorted[run].count));
+                _offsets.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(_sorted[run].firstIndex) * indexSize));
+                _baseVertices.push_back(_sorted[run].baseVertex);
+            }
+            GeometryStore::setTransform(_transforms[transform]);
+            if (_counts.size() == 1) {
+                glDrawElementsBaseVertex(GL_TRIANGLES, _counts[0], type, _offsets[0], _baseVertices[0]);
+            } else {
+                glMultiDrawElementsBaseVertex(GL_TRIANGLES, _counts.data(), type, _offsets.data(), static_cast<GLsizei>(_counts.size()), _baseVertices.data());
+            }
+            _calls++;
+        }
+        begin = end;
+    }
+}
@@ -0,0 +1,249 @@
+#include "GeometryStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <GLState.h>
+
+using namespace std;
+
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+
+namespace {
+    bool hasExtension(const char* name) {
+        GLint count{};
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (extension != nullptr && strcmp(extension, name) == 0) return true;
+        }
+        return false;
+    }
+}
+
+size_t GeometryStore::RangeAllocator::allocate(size_t count) {
+    if (count == 0) return 0;
+    for (auto it = _free.begin(); it != _free.end(); ++it) {
+        if (it->count < count) continue;
+        const size_t first = it->first;
+        it->first += count;
+        it->count -= count;
+        if (it->count == 0) _free.erase(it);
+        return first;
+    }
+    return npos;
+}
+
+void GeometryStore::RangeAllocator::release(size_t first, size_t count) {
+    if (count == 0) return;
+    auto it = lower_bound(_free.begin(), _free.end(), first, [](const Range& range, size_t value) {
+        return range.first < value;
+    });
+    it = _free.insert(it, {first, count});
+    // 与前后相邻的空闲区间合并
+    if (auto next = it + 1; next != _free.end() && it->first + it->count == next->first) {
+        it->count += next->count;
+        _free.erase(next);
+    }
+    if (it != _free.begin()) {
+        if (auto prev = it - 1; prev->first + prev->count == it->first) {
+            prev->count += it->count;
+            _free.erase(it);
+        }
+    }
+}
+
+void GeometryStore::RangeAllocator::grow(size_t capacity) {
+    if (capacity <= _capacity) return;
+    const size_t added = capacity - _capacity;
+    const size_t first = _capacity;
+    _capacity = capacity;
+    release(first, added);
+}
+
+GeometryStore& GeometryStore::shared() {
+    static GeometryStore store{};
+    return store;
+}
+
+void GeometryStore::load(GLADloadproc loader) {
+    _multiDrawElementsIndirect = nullptr;
+    const bool isCore = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3);
+    if (!isCore && !(hasExtension("GL_ARB_multi_draw_indirect") && hasExtension("GL_ARB_base_instance"))) return;
+
+    // GL_ARB_multi_draw_indirect的入口与核心版本同名, 不带后缀
+    _multiDrawElementsIndirect = reinterpret_cast<MultiDrawElementsIndirectProc>(loader("glMultiDrawElementsIndirect"));
+    if (!isIndirect()) return;
+    if (_transformBuffer == 0) glGenBuffers(1, &_transformBuffer);
+    if (_commandBuffer == 0) glGenBuffers(1, &_commandBuffer);
+}
+
+bool GeometryStore::isIndirect() const {
+    return _multiDrawElementsIndirect != nullptr;
+}
+
+GeometryStore::Allocation GeometryStore::allocate(const VertexFormatDescriptor& format, GLenum indexType, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount) {
+    if (format.strides.size() != 1 || format.strides[0] <= 0) return {};
+    for (const auto& a : format.attributes) {
+        if (a.location >= transformLocation) return {};
+    }
+
+    const Pool pool = acquire(format, indexType);
+    PoolEntry& entry = _pools[pool];
+    bool isReallocated{false};
+
+    size_t firstVertex = entry.vertices.allocate(vertexCount);
+    if (firstVertex == RangeAllocator::npos) {
+        const size_t capacity = entry.vertices.capacity();
+        const size_t grown = (std::max)(capacity * 2, capacity + vertexCount);
+        reallocate(entry.vbo, capacity * entry.vertexSize, grown * entry.vertexSize);
+        entry.vertices.grow(grown);
+        firstVertex = entry.vertices.allocate(vertexCount);
+        isReallocated = true;
+    }
+    size_t firstIndex = entry.indices.allocate(indexCount);
+    if (firstIndex == RangeAllocator::npos) {
+        const size_t capacity = entry.indices.capacity();
+        const size_t grown = (std::max)(capacity * 2, capacity + indexCount);
+        reallocate(entry.ebo, capacity * entry.indexSize, grown * entry.indexSize);
+        entry.indices.grow(grown);
+        firstIndex = entry.indices.allocate(indexCount);
+        isReallocated = true;
+    }
+    if (isReallocated) {
+        declare(entry);
+    }
+
+    if (vertexCount != 0) {
+        GLState::shared().bindBuffer(GL_COPY_WRITE_BUFFER, entry.vbo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+            static_cast<GLintptr>(firstVertex * entry.vertexSize),
+            static_cast<GLsizeiptr>(vertexCount * entry.vertexSize),
+            vertices);
+    }
+    if (indexCount != 0) {
+        GLState::shared().bindBuffer(GL_COPY_WRITE_BUFFER, entry.ebo);
+        glBufferSubData(GL_COPY_WRITE_BUFFER,
+            static_cast<GLintptr>(firstIndex * entry.indexSize),
+            static_cast<GLsizeiptr>(indexCount * entry.indexSize),
+            indices);
+    }
+    return {pool, firstVertex, vertexCount, firstIndex, indexCount};
+}
+
+void GeometryStore::release(const Allocation& allocation) {
+    if (allocation.pool >= _pools.size()) return;
+    PoolEntry& entry = _pools[allocation.pool];
+    entry.vertices.release(allocation.firstVertex, allocation.vertexCount);
+    entry.indices.release(allocation.firstIndex, allocation.indexCount);
+}
+
+GLuint GeometryStore::vertexBuffer(Pool pool) const {
+    return _pools[pool].vbo;
+}
+
+GLintptr GeometryStore::vertexOffset(const Allocation& allocation) const {
+    return static_cast<GLintptr>(allocation.firstVertex * _pools[allocation.pool].vertexSize);
+}
+
+GLenum GeometryStore::indexType(Pool pool) const {
+    return _pools[pool].indexType;
+}
+
+void GeometryStore::bind(Pool pool) {
+    GLState::shared().bindVertexArray(_pools[pool].vao);
+}
+
+void GeometryStore::uploadTransforms(const glm::mat4* transforms, size_t count) {
+    GLState::shared().bindBuffer(GL_ARRAY_BUFFER, _transformBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(count * sizeof(glm::mat4)), transforms, GL_STREAM_DRAW);
+}
+
+void GeometryStore::uploadCommands(const DrawCommand* commands, size_t count) {
+    GLState::shared().bindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(count * sizeof(DrawCommand)), commands, GL_STREAM_DRAW);
+}
+
+void GeometryStore::drawIndirect(Pool pool, size_t first, size_t count) const {
+    _multiDrawElementsIndirect(GL_TRIANGLES,
+        _pools[pool].indexType,
+        reinterpret_cast<const void*>(first * sizeof(DrawCommand)),
+        static_cast<GLsizei>(count),
+        0);
+}
+
+void GeometryStore::setTransform(const glm::mat4& transform) {
+    for (GLuint i = 0; i < 4; i++) {
+        glVertexAttrib4fv(transformLocation + i, &transform[static_cast<glm::length_t>(i)][0]);
+    }
+}
+
+void GeometryStore::clear() {
+    GLState& state = GLState::shared();
+    for (PoolEntry& entry : _pools) {
+        state.deleteVertexArrays(1, &entry.vao);
+        state.deleteBuffers(1, &entry.vbo);
+        state.deleteBuffers(1, &entry.ebo);
+    }
+    _pools.clear();
+    state.deleteBuffers(1, &_transformBuffer);
+    state.deleteBuffers(1, &_commandBuffer);
+    _transformBuffer = 0;
+    _commandBuffer = 0;
+    _multiDrawElementsIndirect = nullptr;
+}
+
+size_t GeometryStore::size() const {
+    return _pools.size();
+}
+
+GeometryStore::Pool GeometryStore::acquire(const VertexFormatDescriptor& format, GLenum indexType) {
+    for (Pool i = 0; i < _pools.size(); i++) {
+        if (_pools[i].indexType == indexType && _pools[i].format == format) return i;
+    }
+
+    PoolEntry entry{};
+    entry.format = format;
+    entry.indexType = indexType;
+    entry.vertexSize = static_cast<size_t>(format.strides[0]);
+    entry.indexSize = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    glGenVertexArrays(1, &entry.vao);
+    _pools.push_back(std::move(entry));
+    return _pools.size() - 1;
+}
+
+void GeometryStore::declare(PoolEntry& entry) {
+    GLState& state = GLState::shared();
+    state.bindVertexArray(entry.vao);
+    state.bindBuffer(GL_ARRAY_BUFFER, entry.vbo);
+    for (const auto& a : entry.format.attributes) {
+        glVertexAttribPointer(a.location, a.components, a.type, a.normalized, entry.format.strides[0], reinterpret_cast<void*>(static_cast<uintptr_t>(a.offset)));
+        glEnableVertexAttribArray(a.location);
+    }
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, entry.ebo);
+    if (!isIndirect()) return;
+
+    // 变换按列占据4个属性位置, 每个实例前进一次, 起点由命令的baseInstance决定
+    state.bindBuffer(GL_ARRAY_BUFFER, _transformBuffer);
+    for (GLuint i = 0; i < 4; i++) {
+        glVertexAttribPointer(transformLocation + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), reinterpret_cast<void*>(i * sizeof(glm::vec4)));
+        glVertexAttribDivisor(transformLocation + i, 1);
+        glEnableVertexAttribArray(transformLocation + i);
+    }
+}
+
+void GeometryStore::reallocate(GLuint& buffer, size_t oldSize, size_t newSize) {
+    GLState& state = GLState::shared();
+    GLuint fresh{};
+    glGenBuffers(1, &fresh);
+    state.bindBuffer(GL_COPY_WRITE_BUFFER, fresh);
+    glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(newSize), nullptr, GL_STATIC_DRAW);
+    if (buffer != 0 && oldSize != 0) {
+        state.bindBuffer(GL_COPY_READ_BUFFER, buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(oldSize));
+    }
+    state.deleteBuffers(1, &buffer);
+    buffer = fresh;
+}
@@ -0,0 +1,86 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+uint64_t RenderQueue::key(Pass pass, uint32_t program, uint32_t texture, uint32_t vertexArray, float depth) {
+    const uint64_t state = (static_cast<uint64_t>((std::min)(program, maxState)) << (2 * stateBits))
+        | (static_cast<uint64_t>((std::min)(texture, maxState)) << stateBits)
+        | static_cast<uint64_t>((std::min)(vertexArray, maxState));
+    const uint64_t quantized = quantizeDepth(depth);
+    const uint64_t passBits = static_cast<uint64_t>(pass) << 62;
+    if (pass == Pass::Transparent) {
+        const uint64_t inverted = ((1ull << depthBits) - 1) - quantized;
+        return passBits | (inverted << (3 * stateBits)) | state;
+    }
+    return passBits | (state << depthBits) | quantized;
+}
+
+uint32_t RenderQueue::quantizeDepth(float depth) {
+    if (!(depth > 0.0f)) return 0;
+    uint32_t bits{};
+    memcpy(&bits, &depth, sizeof(float));
+    return bits >> (31 - depthBits);
+}
+
+uint32_t RenderQueue::programSlot(uint32_t program) {
+    return slot(_programs, program);
+}
+
+uint32_t RenderQueue::textureSlot(uint32_t texture) {
+    return slot(_textures, texture);
+}
+
+void RenderQueue::push(uint64_t key, uint32_t item) {
+    _entries.push_back({key, item});
+}
+
+void RenderQueue::sort() {
+    const size_t count = _entries.size();
+    if (count < 2) return;
+
+    size_t histogram[8][256]{};
+    for (const Entry& e : _entries) {
+        for (size_t b = 0; b < 8; b++) {
+            histogram[b][(e.key >> (b * 8)) & 0xFF]++;
+        }
+    }
+
+    _scratch.resize(count);
+    Entry* source = _entries.data();
+    Entry* destination = _scratch.data();
+    for (size_t b = 0; b < 8; b++) {
+        size_t* counts = histogram[b];
+        if (counts[(source[0].key >> (b * 8)) & 0xFF] == count) continue;
+
+        size_t offset{0};
+        for (size_t d = 0; d < 256; d++) {
+            const size_t n = counts[d];
+            counts[d] = offset;
+            offset += n;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const Entry& e = source[i];
+            destination[counts[(e.key >> (b * 8)) & 0xFF]++] = e;
+        }
+        swap(source, destination);
+    }
+    if (source != _entries.data()) {
+        _entries.swap(_scratch);
+    }
+}
+
+const vector<RenderQueue::Entry>& RenderQueue::entries() const {
+    return _entries;
+}
+
+void RenderQueue::clear() {
+    _entries.clear();
+}
+
+uint32_t RenderQueue::slot(unordered_map<uint32_t, uint32_t>& slots, uint32_t id) {
+    const auto it = slots.emplace(id, static_cast<uint32_t>(slots.size())).first;
+    return (std::min)(it->second, maxState);
+}
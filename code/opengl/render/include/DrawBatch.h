@@ -0,0 +1,117 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "GeometryStore.h"
+#include "RenderQueue.h"
+
+/**
+ * @brief 一趟绘制的合并提交
+ * @details 收集本趟中位于GeometryStore的网格绘制, 提交时经RenderQueue按阶段, 着色器程序, 纹理, 池与深度排序,
+ *          程序, 纹理与池均相同的连续绘制为一组, 每组经GLState切换程序, 纹理与顶点数组对象, 与当前相同的部分不发出调用.
+ *          支持间接绘制时每组以一次glMultiDrawElementsIndirect提交, 变换经实例属性由baseInstance选择;
+ *          否则对使用同一变换的连续绘制设置一次常量变换属性后以glMultiDrawElementsBaseVertex提交.
+ *          组内按深度排列, 不透明绘制由近及远. 只能在渲染线程使用
+ */
+class DrawBatch {
+    public:
+        /**
+         * @brief 记录变换
+         * @details 同一网格的多段绘制(例如可见簇)共用一个变换
+         * @param transform 变换矩阵, 即投影, 观察与模型矩阵之积
+         * @return 变换下标
+         */
+        size_t transform(const glm::mat4& transform);
+
+        /**
+         * @brief 记录绘制
+         * @details 他似乎不需要详细注释[划掉]
+         * @param program 着色器程序id
+         * @param texture 绑定到GL_TEXTURE_2D的纹理id
+         * @param allocation 网格分配
+         * @param firstIndex 网格内的首个索引
+         * @param indexCount 索引数量
+         * @param transform transform返回的变换下标
+         * @param depth 观察空间中到摄像机的距离
+         * @param pass 绘制阶段
+         */
+        void draw(GLuint program, GLuint texture, const GeometryStore::Allocation& allocation, size_t firstIndex, size_t indexCount,
+            size_t transform, float depth, RenderQueue::Pass pass = RenderQueue::Pass::Opaque);
+
+        /**
+         * @brief 提交并清空记录
+         * @details 提交后当前着色器程序, 纹理与顶点数组对象为最后一组所用
+         * @param store 几何存储
+         */
+        void submit(GeometryStore& store);
+
+        /**
+         * @brief 获取上次提交的绘制调用数
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 绘制调用数
+         */
+        [[nodiscard]] size_t calls() const;
+
+        /**
+         * @brief 获取上次提交的绘制数
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 记录的绘制数
+         */
+        [[nodiscard]] size_t draws() const;
+
+    private:
+        struct Draw {
+            GLuint program;
+            GLuint texture;
+            GeometryStore::Pool pool;
+            GLuint count;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint transform;
+        };
+
+        RenderQueue _queue;
+        std::vector<Draw> _draws;
+        std::vector<Draw> _sorted;
+        std::vector<glm::mat4> _transforms;
+        std::vector<GeometryStore::DrawCommand> _commands;
+        std::vector<GLsizei> _counts;
+        std::vector<const void*> _offsets;
+        std::vector<GLint> _baseVertices;
+        size_t _calls{};
+        size_t _submitted{};
+
+        /**
+         * @brief 是否与上一绘制属于同一组
+         * @details 他似乎不需要详细注释[划掉]
+         * @param a 上一绘制
+         * @param b 绘制
+         * @return 程序, 纹理与池是否均相同
+         */
+        static bool isSameGroup(const Draw& a, const Draw& b);
+
+        /**
+         * @brief 切换到绘制所需的状态
+         * @details 纹理绑定到0号纹理单元
+         * @param store 几何存储
+         * @param d 组首个绘制
+         */
+        static void bindGroup(GeometryStore& store, const Draw& d);
+
+        /**
+         * @brief 以间接绘制提交
+         * @details 他似乎不需要详细注释[划掉]
+         * @param store 几何存储
+         */
+        void submitIndirect(GeometryStore& store);
+
+        /**
+         * @brief 以逐组多重绘制提交
+         * @details 他似乎不需要详细注释[划掉]
+         * @param store 几何存储
+         */
+        void submitDirect(GeometryStore& store);
+};
@@ -0,0 +1,243 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <VertexFormat.h>
+
+/**
+ * @brief 共享几何存储
+ * @details 顶点格式与索引类型相同的静态网格共用一对顶点/索引缓冲区(池), 每个网格在其中分配一段顶点与一段索引.
+ *          索引保持网格内的局部值, 绘制时以baseVertex偏移, 因此16位索引的网格仍可使用16位索引.
+ *          每个池拥有一个顶点数组对象, 同一池的网格之间切换不需要任何绑定, 一趟绘制可由DrawBatch合并为少量多重绘制调用.
+ *          各绘制的变换以实例属性(transformLocation起的4个位置)提供: 支持间接绘制(GL 4.3或GL_ARB_multi_draw_indirect与GL_ARB_base_instance)时
+ *          属性来自变换缓冲区, 由命令的baseInstance选择; 不支持时以常量顶点属性逐次设置. glad只生成到GL 3.3, 间接绘制的入口在load中手动取得.
+ *          缓冲区的写入均经GL_COPY_WRITE_BUFFER进行, 不改变任何顶点数组对象的绑定. 只能在渲染线程使用
+ */
+class GeometryStore {
+    public:
+        using Pool = size_t;
+        static constexpr Pool invalidPool = ~size_t{0};
+        static constexpr GLuint transformLocation = 12;
+
+        /**
+         * @brief 网格分配
+         * @details firstVertex即绘制时的baseVertex, firstIndex以索引为单位
+         */
+        struct Allocation {
+            Pool pool{invalidPool};
+            size_t firstVertex{};
+            size_t vertexCount{};
+            size_t firstIndex{};
+            size_t indexCount{};
+
+            /**
+             * @brief 是否有效
+             * @details 他似乎不需要详细注释[划掉]
+             * @return 是否有效
+             */
+            [[nodiscard]] bool isValid() const {
+                return pool != invalidPool;
+            }
+        };
+
+        /**
+         * @brief 间接绘制命令
+         * @details 与glMultiDrawElementsIndirect要求的结构一致
+         */
+        struct DrawCommand {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+
+        /**
+         * @brief 获取共享存储
+         * @details 对应渲染线程的上下文
+         * @return 存储引用
+         */
+        static GeometryStore& shared();
+
+        /**
+         * @brief 检查间接绘制支持并取得入口
+         * @details 须在gladLoadGLLoader之后, 首次分配之前于渲染线程调用; 未调用时使用逐次绘制
+         * @param loader 函数地址查询, 例如glfwGetProcAddress
+         */
+        void load(GLADloadproc loader);
+
+        /**
+         * @brief 是否支持间接绘制
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 是否支持
+         */
+        [[nodiscard]] bool isIndirect() const;
+
+        /**
+         * @brief 分配并上传网格
+         * @details 顶点格式需只有一个绑定点(交错顶点), 否则返回无效分配. 池空间不足时按倍数扩容, 已有数据以glCopyBufferSubData搬移
+         * @param format 顶点格式描述
+         * @param indexType 索引类型, GL_UNSIGNED_SHORT或GL_UNSIGNED_INT
+         * @param vertices 按format打包的顶点数据
+         * @param vertexCount 顶点数量
+         * @param indices 按indexType打包的索引数据
+         * @param indexCount 索引数量
+         * @return 分配
+         */
+        Allocation allocate(const VertexFormatDescriptor& format, GLenum indexType, const void* vertices, size_t vertexCount, const void* indices, size_t indexCount);
+
+        /**
+         * @brief 释放网格
+         * @details 空间归还所在的池供之后的分配复用, 缓冲区不缩小
+         * @param allocation 分配
+         */
+        void release(const Allocation& allocation);
+
+        /**
+         * @brief 获取池的顶点缓冲区
+         * @details 扩容后会更换, 不应长期保存
+         * @param pool 池
+         * @return 顶点缓冲区
+         */
+        [[nodiscard]] GLuint vertexBuffer(Pool pool) const;
+
+        /**
+         * @brief 获取网格顶点在顶点缓冲区中的字节偏移
+         * @details 他似乎不需要详细注释[划掉]
+         * @param allocation 分配
+         * @return 字节偏移
+         */
+        [[nodiscard]] GLintptr vertexOffset(const Allocation& allocation) const;
+
+        /**
+         * @brief 获取池的索引类型
+         * @details 他似乎不需要详细注释[划掉]
+         * @param pool 池
+         * @return 索引类型
+         */
+        [[nodiscard]] GLenum indexType(Pool pool) const;
+
+        /**
+         * @brief 绑定池的顶点数组对象
+         * @details 经GLState绑定, 与当前相同时不发出调用
+         * @param pool 池
+         */
+        void bind(Pool pool);
+
+        /**
+         * @brief 上传本趟绘制的变换
+         * @details 仅间接绘制使用, 第i个矩阵对应baseInstance为i的命令
+         * @param transforms 变换矩阵
+         * @param count 矩阵数量
+         */
+        void uploadTransforms(const glm::mat4* transforms, size_t count);
+
+        /**
+         * @brief 上传本趟绘制的间接绘制命令
+         * @details 仅间接绘制使用
+         * @param commands 命令
+         * @param count 命令数量
+         */
+        void uploadCommands(const DrawCommand* commands, size_t count);
+
+        /**
+         * @brief 以间接绘制提交当前绑定池的命令
+         * @details 命令取自uploadCommands上传的缓冲区
+         * @param pool 池, 需已绑定
+         * @param first 首个命令的下标
+         * @param count 命令数量
+         */
+        void drawIndirect(Pool pool, size_t first, size_t count) const;
+
+        /**
+         * @brief 以常量顶点属性设置变换
+         * @details 用于未启用变换实例属性的顶点数组对象, 包括不在存储中的网格与不支持间接绘制时的逐次绘制
+         * @param transform 变换矩阵
+         */
+        static void setTransform(const glm::mat4& transform);
+
+        /**
+         * @brief 删除所有缓冲区与顶点数组对象
+         * @details 之后对此前分配的release不做任何事. 须在上下文销毁前于渲染线程调用
+         */
+        void clear();
+
+        /**
+         * @brief 获取池数量
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 池数量
+         */
+        [[nodiscard]] size_t size() const;
+
+    private:
+        using MultiDrawElementsIndirectProc = void (APIENTRYP)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+        /**
+         * @brief 区间分配器
+         * @details 以首次适配在空闲区间中分配, 释放时与相邻空闲区间合并
+         */
+        class RangeAllocator {
+            public:
+                static constexpr size_t npos = ~size_t{0};
+
+                size_t allocate(size_t count);
+                void release(size_t first, size_t count);
+                void grow(size_t capacity);
+                [[nodiscard]] size_t capacity() const {
+                    return _capacity;
+                }
+            private:
+                struct Range {
+                    size_t first;
+                    size_t count;
+                };
+                std::vector<Range> _free;
+                size_t _capacity{};
+        };
+
+        struct PoolEntry {
+            VertexFormatDescriptor format;
+            GLenum indexType{GL_UNSIGNED_INT};
+            size_t vertexSize{};
+            size_t indexSize{};
+            GLuint vao{};
+            GLuint vbo{};
+            GLuint ebo{};
+            RangeAllocator vertices;
+            RangeAllocator indices;
+        };
+
+        MultiDrawElementsIndirectProc _multiDrawElementsIndirect{};
+        std::vector<PoolEntry> _pools;
+        GLuint _transformBuffer{};
+        GLuint _commandBuffer{};
+
+        /**
+         * @brief 查找或创建池
+         * @details 他似乎不需要详细注释[划掉]
+         * @param format 顶点格式描述
+         * @param indexType 索引类型
+         * @return 池
+         */
+        Pool acquire(const VertexFormatDescriptor& format, GLenum indexType);
+
+        /**
+         * @brief 声明池的顶点数组对象
+         * @details 创建池与顶点缓冲区更换后调用
+         * @param entry 池
+         */
+        void declare(PoolEntry& entry);
+
+        /**
+         * @brief 扩容缓冲区
+         * @details 新建缓冲区并以glCopyBufferSubData搬移已有数据
+         * @param buffer 缓冲区, 更换为新缓冲区
+         * @param oldSize 原字节数
+         * @param newSize 新字节数
+         */
+        static void reallocate(GLuint& buffer, size_t oldSize, size_t newSize);
+};
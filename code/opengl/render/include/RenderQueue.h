@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 排序渲染队列
+ * @details 每次提交以64位排序键与提交方自己的下标入队, 每帧以基数排序后按键序取出, 使状态切换最少.
+ *          不透明键从高到低为: 绘制阶段(2位), 着色器程序(12位), 纹理(12位), 顶点数组对象(12位), 深度(24位),
+ *          同状态的绘制由近及远, 利于提前深度测试; 透明键将反转后的深度放在阶段之后, 保证由远及近.
+ *          程序与纹理以id按首次出现的顺序换算为紧凑编号, 跨帧保持不变; 编号超出12位时并入最后一个编号, 只影响分组不影响正确性.
+ *          基数排序稳定, 键相同时保持入队顺序
+ */
+class RenderQueue {
+    public:
+        enum class Pass : uint8_t {
+            Opaque = 0,
+            Transparent = 1,
+        };
+
+        /**
+         * @brief 队列项
+         * @details item为提交方的下标
+         */
+        struct Entry {
+            uint64_t key;
+            uint32_t item;
+        };
+
+        static constexpr uint32_t stateBits = 12;
+        static constexpr uint32_t depthBits = 24;
+        static constexpr uint32_t maxState = (1u << stateBits) - 1;
+
+        /**
+         * @brief 生成排序键
+         * @details 他似乎不需要详细注释[划掉]
+         * @param pass 绘制阶段
+         * @param program 着色器程序编号, 由programSlot得到
+         * @param texture 纹理编号, 由textureSlot得到
+         * @param vertexArray 顶点数组对象编号, 例如GeometryStore的池
+         * @param depth 观察空间中到摄像机的距离
+         * @return 排序键
+         */
+        static uint64_t key(Pass pass, uint32_t program, uint32_t texture, uint32_t vertexArray, float depth);
+
+        /**
+         * @brief 将深度量化为24位
+         * @details 非负浮点数的位模式与数值同序, 取其高24位(去掉符号位)即可保序; 负数按0处理
+         * @param depth 深度
+         * @return 量化后的深度
+         */
+        static uint32_t quantizeDepth(float depth);
+
+        /**
+         * @brief 获取着色器程序的紧凑编号
+         * @details 他似乎不需要详细注释[划掉]
+         * @param program 着色器程序id
+         * @return 编号
+         */
+        uint32_t programSlot(uint32_t program);
+
+        /**
+         * @brief 获取纹理的紧凑编号
+         * @details 他似乎不需要详细注释[划掉]
+         * @param texture 纹理id
+         * @return 编号
+         */
+        uint32_t textureSlot(uint32_t texture);
+
+        /**
+         * @brief 入队
+         * @details 他似乎不需要详细注释[划掉]
+         * @param key 排序键
+         * @param item 提交方的下标
+         */
+        void push(uint64_t key, uint32_t item);
+
+        /**
+         * @brief 按键排序
+         * @details 以8位为一趟的LSD基数排序, 一次遍历统计全部8个字节的直方图, 所有键在某字节上相同时跳过该趟
+         */
+        void sort();
+
+        /**
+         * @brief 获取队列项
+         * @details sort之后按键升序排列
+         * @return 队列项数组引用
+         */
+        [[nodiscard]] const std::vector<Entry>& entries() const;
+
+        /**
+         * @brief 清空队列项
+         * @details 程序与纹理的编号保留
+         */
+        void clear();
+
+    private:
+        std::vector<Entry> _entries;
+        std::vector<Entry> _scratch;
+        std::unordered_map<uint32_t, uint32_t> _programs;
+        std::unordered_map<uint32_t, uint32_t> _textures;
+
+        /**
+         * @brief 查找或分配紧凑编号
+         * @details 他似乎不需要详细注释[划掉]
+         * @param slots 编号表
+         * @param id 对象id
+         * @return 编号
+         */
+        static uint32_t slot(std::unordered_map<uint32_t, uint32_t>& slots, uint32_t id);
+};
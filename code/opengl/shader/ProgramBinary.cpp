@@ -0,0 +1,180 @@
+#include "ProgramBinary.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <GlobalLogger.hpp>
+#include <Hash.hpp>
+
+using namespace std;
+namespace fs = filesystem;
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_PROGRAM_BINARY_FORMATS
+#define GL_PROGRAM_BINARY_FORMATS 0x87FF
+#endif
+
+namespace {
+    bool hasExtension(const char* name) {
+        GLint count{};
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (extension != nullptr && strcmp(extension, name) == 0) return true;
+        }
+        return false;
+    }
+
+    uint64_t hashString(GLenum name, uint64_t seed) {
+        const auto* value = reinterpret_cast<const char*>(glGetString(name));
+        return value == nullptr ? seed : hashing::fnv1a(string_view(value), seed);
+    }
+}
+
+ProgramBinary& ProgramBinary::shared() {
+    static ProgramBinary cache{};
+    return cache;
+}
+
+void ProgramBinary::load(GLADloadproc loader, const fs::path& directory) {
+    _getProgramBinary = nullptr;
+    _programBinary = nullptr;
+    _programParameteri = nullptr;
+    _formats.clear();
+    const bool isCore = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1);
+    if (!isCore && !hasExtension("GL_ARB_get_program_binary")) return;
+
+    // 驱动可能声明支持但不提供任何二进制格式, 此时取回的二进制无法装载
+    GLint formats{};
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) return;
+
+    error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) {
+        glog.log<DefaultLevel::Error>("无法创建着色器程序缓存目录 " + directory.string() + ": " + ec.message());
+        return;
+    }
+
+    // GL_ARB_get_program_binary的入口与核心版本同名, 不带后缀
+    _getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(loader("glGetProgramBinary"));
+    _programBinary = reinterpret_cast<ProgramBinaryProc>(loader("glProgramBinary"));
+    _programParameteri = reinterpret_cast<ProgramParameteriProc>(loader("glProgramParameteri"));
+    if (!isSupported()) {
+        _getProgramBinary = nullptr;
+        _programBinary = nullptr;
+        _programParameteri = nullptr;
+        return;
+    }
+    _formats.resize(static_cast<size_t>(formats));
+    glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, _formats.data());
+    _directory = directory;
+    _device = hashString(GL_VERSION, hashString(GL_RENDERER, hashString(GL_VENDOR, hashing::fnv1aOffset)));
+}
+
+bool ProgramBinary::isSupported() const {
+    return _getProgramBinary != nullptr && _programBinary != nullptr && _programParameteri != nullptr;
+}
+
+bool ProgramBinary::restore(GLuint program, uint64_t key) const {
+    if (!isSupported()) return false;
+    const fs::path path = pathOf(key);
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+
+    // 长度与格式在分配前校验, 损坏的文件头不会引发超大分配, 也不会把未知格式交给驱动
+    error_code ec;
+    const uintmax_t size = fs::file_size(path, ec);
+    FileHeader header{};
+    vector<char> binary;
+    bool isValid = !ec && static_cast<bool>(in.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)))
+        && header.magic == magic && header.version == version && header.key == key && header.device == _device
+        && size - sizeof(FileHeader) == header.length && isFormat(header.format);
+    if (isValid) {
+        binary.resize(header.length);
+        isValid = static_cast<bool>(in.read(binary.data(), static_cast<streamsize>(binary.size())))
+            && hashing::fnv1a(binary.data(), binary.size()) == header.hash;
+    }
+    in.close();
+
+    GLint success{};
+    if (isValid) {
+        _programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+    }
+    if (!success) {
+        // 驱动更新后旧二进制会被拒绝, 删除后由重新链接的结果覆盖
+        glog.log<DefaultLevel::Warn>(string(isValid ? "着色器程序二进制被驱动拒绝" : "着色器程序二进制缓存已损坏或过期")
+            + ", 删除 " + path.string());
+        fs::remove(path, ec);
+        return false;
+    }
+    return true;
+}
+
+void ProgramBinary::retrievable(GLuint program) const {
+    if (!isSupported()) return;
+    _programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool ProgramBinary::store(GLuint program, uint64_t key) const {
+    if (!isSupported()) return false;
+    GLint length{};
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    vector<char> binary(static_cast<size_t>(length));
+    GLsizei written{};
+    GLenum format{};
+    _getProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return false;
+    binary.resize(static_cast<size_t>(written));
+
+    const fs::path path = pathOf(key);
+    fs::path temp = path;
+    temp += ".tmp";
+    error_code ec;
+    {
+        ofstream out(temp, ios::binary | ios::trunc);
+        if (!out.is_open()) return false;
+        const FileHeader header{magic, version, key, _device, hashing::fnv1a(binary.data(), binary.size()),
+            static_cast<uint32_t>(format), static_cast<uint32_t>(binary.size())};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        out.write(binary.data(), static_cast<streamsize>(binary.size()));
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool ProgramBinary::isFormat(uint32_t format) const {
+    return find(_formats.begin(), _formats.end(), static_cast<GLint>(format)) != _formats.end();
+}
+
+fs::path ProgramBinary::pathOf(uint64_t key) const {
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hashing::combine(key, _device)));
+    return _directory / name;
+}
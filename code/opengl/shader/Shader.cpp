@@ -4,7 +4,7 @@
 
 using namespace std;
 
-Shader::Shader(ShaderType shaderType, const string &shaderSource) {
+Shader::Shader(ShaderType shaderType, string_view shaderSource) {
     if (shaderSource.empty()) {
         cerr << "错误: 着色器源码为空" << endl;
         _location = 0;
@@ -15,8 +15,9 @@ Shader::Shader(ShaderType shaderType, const string &shaderSource) {
     int success;
     char infoLog[512];
 
-    const GLchar* source = shaderSource.c_str();
-    glShaderSource(_location, 1, &source, nullptr);
+    const GLchar* source = shaderSource.data();
+    const GLint length = static_cast<GLint>(shaderSource.size());
+    glShaderSource(_location, 1, &source, &length);
     glCompileShader(_location);
     glGetShaderiv(_location, GL_COMPILE_STATUS, &success);
     if (!success) {
@@ -0,0 +1,98 @@
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <Hash.hpp>
+
+using namespace std;
+
+namespace {
+    double elapsedMilliseconds(chrono::steady_clock::time_point begin) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    }
+}
+
+ShaderCache& ShaderCache::shared() {
+    static ShaderCache cache{};
+    return cache;
+}
+
+shared_ptr<Shader> ShaderCache::shader(Shader::ShaderType type, string_view source) {
+    const uint64_t hash = stageHash(type, source);
+    auto [begin, end] = _shaders.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second.type == type && it->second.source == source) {
+            _statistics.shaderHits++;
+            return it->second.shader;
+        }
+    }
+
+    const auto compileBegin = chrono::steady_clock::now();
+    auto compiled = make_shared<Shader>(type, source);
+    _statistics.compileMilliseconds += elapsedMilliseconds(compileBegin);
+    _statistics.compiles++;
+    _shaders.emplace(hash, ShaderEntry{type, string(source), compiled});
+    return compiled;
+}
+
+shared_ptr<ShaderProgram> ShaderCache::program(initializer_list<Stage> stages) {
+    uint64_t hash = hashing::fnv1aOffset;
+    for (const auto& [type, source] : stages) {
+        hash = hashing::combine(hash, stageHash(type, source));
+    }
+
+    auto [begin, end] = _programs.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        const auto& cached = it->second.stages;
+        if (equal(cached.begin(), cached.end(), stages.begin(), stages.end(), [](const auto& a, const Stage& b) {
+            return a.first == b.first && a.second == b.second;
+        })) {
+            _statistics.programHits++;
+            return it->second.program;
+        }
+    }
+
+    ProgramEntry entry{};
+    entry.program = make_shared<ShaderProgram>();
+    for (const auto& [type, source] : stages) {
+        entry.stages.emplace_back(type, string(source));
+    }
+
+    const auto binaryBegin = chrono::steady_clock::now();
+    const bool isRestored = entry.program->load(hash);
+    _statistics.binaryMilliseconds += elapsedMilliseconds(binaryBegin);
+    if (isRestored) {
+        _statistics.binaryLoads++;
+    } else {
+        vector<shared_ptr<Shader>> shaders;
+        shaders.reserve(stages.size());
+        for (const auto& [type, source] : stages) {
+            shaders.push_back(shader(type, source));
+        }
+        const auto linkBegin = chrono::steady_clock::now();
+        for (const auto& s : shaders) {
+            entry.program->attach(*s);
+        }
+        (void) entry.program->link(hash);
+        _statistics.linkMilliseconds += elapsedMilliseconds(linkBegin);
+        _statistics.links++;
+    }
+
+    auto linked = entry.program;
+    _programs.emplace(hash, move(entry));
+    return linked;
+}
+
+const ShaderCache::Statistics& ShaderCache::statistics() const {
+    return _statistics;
+}
+
+uint64_t ShaderCache::stageHash(Shader::ShaderType type, string_view source) {
+    return hashing::fnv1a(source, hashing::fnv1a(&type, sizeof(type)));
+}
+
+void ShaderCache::clear() {
+    _programs.clear();
+    _shaders.clear();
+}
@@ -1,7 +1,10 @@
 #include "ShaderProgram.h"
+#include "ProgramBinary.h"
 #include <glad/glad.h>
 #include <iostream>
 
+#include <GlobalLogger.hpp>
+
 using namespace std;
 
 ShaderProgram::ShaderProgram() {
@@ -18,9 +21,32 @@ void ShaderProgram::attach(const Shader& shader) const {
 }
 
 bool ShaderProgram::link() {
+    glLinkProgram(_location);
+    return checkLink();
+}
+
+bool ShaderProgram::link(uint64_t binaryKey) {
+    const ProgramBinary& binary = ProgramBinary::shared();
+    binary.retrievable(_location);
+    glLinkProgram(_location);
+    if (!checkLink()) return false;
+    if (binary.isSupported() && !binary.store(_location, binaryKey)) {
+        glog.log<DefaultLevel::Warn>("着色器程序二进制保存失败");
+    }
+    return true;
+}
+
+bool ShaderProgram::load(uint64_t binaryKey) {
+    if (!ProgramBinary::shared().restore(_location, binaryKey)) return false;
+    isLink = true;
+    deInitUniformMap();
+    initUniformMap();
+    return true;
+}
+
+bool ShaderProgram::checkLink() {
     int success;
     char infoLog[512];
-    glLinkProgram(_location);
     glGetProgramiv(_location, GL_LINK_STATUS, &success);
     if (!success) {
         glGetProgramInfoLog(_location, 512, nullptr, infoLog);
@@ -28,14 +54,11 @@ bool ShaderProgram::link() {
         return isLink = false;
     }
     isLink = true;
+    deInitUniformMap();
     initUniformMap();
     return isLink;
 }
 
-void ShaderProgram::use() const {
-    glUseProgram(_location);
-}
-
 void ShaderProgram::initUniformMap() {
     int count{};
     int maxLen{};
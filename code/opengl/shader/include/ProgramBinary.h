@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * @brief 着色器程序二进制磁盘缓存
+ * @details 链接成功的程序以glGetProgramBinary取出写入缓存目录, 之后的运行以glProgramBinary直接装载, 跳过编译与链接.
+ *          文件以源码哈希与GL_VENDOR/GL_RENDERER/GL_VERSION的哈希共同命名, 更换驱动或显卡后自然失效; 被驱动拒绝的文件会被删除.
+ *          需要GL 4.1或GL_ARB_get_program_binary, glad只生成到GL 3.3, 入口在load中手动取得.
+ *          未调用load或不支持时isSupported为false, 调用方照常编译链接. 只能在渲染线程使用
+ */
+class ProgramBinary {
+    public:
+        static constexpr uint32_t magic = 0x4E42504C;  // "LPBN"
+        static constexpr uint32_t version = 1;
+
+        /**
+         * @brief 获取共享缓存
+         * @details 对应渲染线程的上下文
+         * @return 缓存引用
+         */
+        static ProgramBinary& shared();
+
+        /**
+         * @brief 检查程序二进制支持并取得入口
+         * @details 须在gladLoadGLLoader之后于渲染线程调用, 缓存目录不存在时创建
+         * @param loader 函数地址查询, 例如glfwGetProcAddress
+         * @param directory 缓存目录
+         */
+        void load(GLADloadproc loader, const std::filesystem::path& directory);
+
+        /**
+         * @brief 是否支持程序二进制
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 是否支持
+         */
+        [[nodiscard]] bool isSupported() const;
+
+        /**
+         * @brief 从缓存装载程序
+         * @details 文件不存在, 损坏或被驱动拒绝时返回false, 程序对象需重新附加着色器并链接.
+         *          文件头的长度与文件大小不符或格式不在驱动支持的列表中时视为损坏, 不读取二进制; 损坏与被拒绝的文件都会被删除
+         * @param program 着色器程序id, 尚未链接
+         * @param key 源码哈希
+         * @return 是否装载并链接成功
+         */
+        [[nodiscard]] bool restore(GLuint program, uint64_t key) const;
+
+        /**
+         * @brief 标记程序二进制可取回
+         * @details 须在glLinkProgram之前调用, 部分驱动不设置此提示时取不到二进制
+         * @param program 着色器程序id
+         */
+        void retrievable(GLuint program) const;
+
+        /**
+         * @brief 保存程序到缓存
+         * @details 先写临时文件再重命名, 写入中途退出不会留下不完整的缓存
+         * @param program 着色器程序id, 已链接成功
+         * @param key 源码哈希
+         * @return 是否保存成功
+         */
+        bool store(GLuint program, uint64_t key) const;
+
+    private:
+        using GetProgramBinaryProc = void (APIENTRYP)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+        using ProgramBinaryProc = void (APIENTRYP)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+        using ProgramParameteriProc = void (APIENTRYP)(GLuint program, GLenum pname, GLint value);
+
+        /**
+         * @brief 缓存文件头
+         * @details 文件中紧随其后的是length字节的程序二进制
+         */
+        struct FileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t key;
+            uint64_t device;
+            uint64_t hash;
+            uint32_t format;
+            uint32_t length;
+        };
+
+        GetProgramBinaryProc _getProgramBinary{};
+        ProgramBinaryProc _programBinary{};
+        ProgramParameteriProc _programParameteri{};
+        std::vector<GLint> _formats;
+        std::filesystem::path _directory;
+        uint64_t _device{};
+
+        /**
+         * @brief 是否为驱动支持的二进制格式
+         * @details 他似乎不需要详细注释[划掉]
+         * @param format 文件头中的格式
+         * @return 是否支持
+         */
+        [[nodiscard]] bool isFormat(uint32_t format) const;
+
+        /**
+         * @brief 获取缓存文件路径
+         * @details 他似乎不需要详细注释[划掉]
+         * @param key 源码哈希
+         * @return 路径
+         */
+        [[nodiscard]] std::filesystem::path pathOf(uint64_t key) const;
+};
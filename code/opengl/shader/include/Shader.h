@@ -1,6 +1,7 @@
 #pragma once
 #include "glad/glad.h"
 #include <string>
+#include <string_view>
 
 /**
  * @brief 着色器包装
@@ -17,9 +18,9 @@ class Shader {
          * @brief 着色器构造并编译
          * @details 他似乎不需要详细注释[划掉]
          * @param shaderType 着色器类型
-         * @param shaderSource 着色器源码
+         * @param shaderSource 着色器源码, 可直接指向映射文件内存, 无需以\0结尾
          */
-        explicit Shader(ShaderType shaderType, const std::string& shaderSource);
+        explicit Shader(ShaderType shaderType, std::string_view shaderSource);
         ~Shader();
 
         /**
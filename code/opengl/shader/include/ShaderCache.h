@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Shader.h"
+#include "ShaderProgram.h"
+
+/**
+ * @brief 着色器缓存
+ * @details 进程内按阶段与源码哈希去重已编译的着色器与已链接的着色器程序.
+ *          源码相同的模型共享同一着色器程序, 只编译链接一次, 统一变量表也只构建一次.
+ *          哈希相同时仍比较源码全文, 哈希冲突不会返回错误的着色器.
+ *          程序的源码哈希同时作为ProgramBinary的键, 磁盘缓存命中时不编译任何着色器. 只能在渲染线程使用
+ */
+class ShaderCache {
+    public:
+        using Stage = std::pair<Shader::ShaderType, std::string_view>;
+
+        /**
+         * @brief 缓存统计
+         * @details 耗时为glCompileShader/glLinkProgram/glProgramBinary及其状态查询的调用耗时, 驱动延迟编译的部分不计入.
+         *          binaryMilliseconds包含未命中的磁盘查找
+         */
+        struct Statistics {
+            size_t compiles{};
+            size_t shaderHits{};
+            size_t links{};
+            size_t programHits{};
+            size_t binaryLoads{};
+            double compileMilliseconds{};
+            double linkMilliseconds{};
+            double binaryMilliseconds{};
+        };
+
+        /**
+         * @brief 获取共享缓存
+         * @details 对应渲染线程的上下文
+         * @return 缓存引用
+         */
+        static ShaderCache& shared();
+
+        /**
+         * @brief 获取着色器
+         * @details 阶段与源码均相同的着色器只编译一次
+         * @param type 着色器类型
+         * @param source 着色器源码, 可直接指向映射文件内存
+         * @return 共享的着色器
+         */
+        std::shared_ptr<Shader> shader(Shader::ShaderType type, std::string_view source);
+
+        /**
+         * @brief 获取着色器程序
+         * @details 各阶段的类型与源码均相同的程序只创建一次. 首次创建时先尝试从ProgramBinary装载,
+         *          失败时各阶段着色器依次取自shader并链接, 成功后保存程序二进制.
+         *          链接失败的程序同样会被缓存, 错误只在首次链接时输出
+         * @param stages 各阶段的类型与源码, 按附加顺序排列
+         * @return 共享的着色器程序
+         */
+        std::shared_ptr<ShaderProgram> program(std::initializer_list<Stage> stages);
+
+        /**
+         * @brief 获取统计
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 统计引用
+         */
+        [[nodiscard]] const Statistics& statistics() const;
+
+        /**
+         * @brief 释放缓存持有的着色器与着色器程序
+         * @details 仍被持有的句柄在其最后一个持有者析构时删除. 须在上下文销毁前于渲染线程调用
+         */
+        void clear();
+
+    private:
+        struct ShaderEntry {
+            Shader::ShaderType type{};
+            std::string source;
+            std::shared_ptr<Shader> shader;
+        };
+
+        struct ProgramEntry {
+            std::vector<std::pair<Shader::ShaderType, std::string>> stages;
+            std::shared_ptr<ShaderProgram> program;
+        };
+
+        /**
+         * @brief 计算阶段哈希
+         * @details 他似乎不需要详细注释[划掉]
+         * @param type 着色器类型
+         * @param source 着色器源码
+         * @return 哈希值
+         */
+        static uint64_t stageHash(Shader::ShaderType type, std::string_view source);
+
+        std::unordered_multimap<uint64_t, ShaderEntry> _shaders;
+        std::unordered_multimap<uint64_t, ProgramEntry> _programs;
+        Statistics _statistics{};
+};
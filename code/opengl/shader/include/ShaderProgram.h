@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 #include <map>
 
 #include "Shader.h"
@@ -27,10 +28,20 @@ class ShaderProgram {
         [[nodiscard]] bool link();
 
         /**
-         * @brief 使用着色器
-         * @details 他似乎不需要详细注释[划掉]
+         * @brief 链接着色器并保存程序二进制
+         * @details ProgramBinary可用时, 链接成功后将程序二进制写入磁盘缓存, 不可用时与link()相同
+         * @param binaryKey 程序的源码哈希
+         * @return 是否链接成功
+         */
+        [[nodiscard]] bool link(uint64_t binaryKey);
+
+        /**
+         * @brief 从磁盘缓存装载程序二进制
+         * @details 成功时无需附加着色器与链接; 失败时程序保持未链接, 可照常附加着色器后调用link
+         * @param binaryKey 程序的源码哈希
+         * @return 是否装载成功
          */
-        void use() const;
+        [[nodiscard]] bool load(uint64_t binaryKey);
 
         /**
          * @brief 通过类型转换操作符获取着色器程序id
@@ -60,6 +71,7 @@ class ShaderProgram {
         bool isLink {};
         std::map<std::string, ShaderUniform> uniformMap;
 
+        bool checkLink();
         void initUniformMap();
         void deInitUniformMap();
 
@@ -1,8 +1,15 @@
 #include "Model.h"
 
+#include <algorithm>
+
 #include <TestRenderCode.h>
 
 #include <Bezier.h>
+#include <Frustum.h>
+#include <GLState.h>
+#include <ShaderCache.h>
+#include <StaticVertexLayout.hpp>
+#include <VertexArrayCache.h>
 #include <EventTypes.hpp>
 
 using namespace std;
@@ -11,10 +18,44 @@ namespace fs = filesystem;
 const fs::path vertexPath = "resource/shader/vertex.glsl";
 const fs::path fragmentPath = "resource/shader/fragment.glsl";
 
+namespace {
+    using PackedPosition = VertexAttribute<attribute::position, 3, StorageFormat::Half>;
+    using UnitTexCoord = VertexAttribute<attribute::texCoord, 2, StorageFormat::Unorm16>;
+    using PackedNormal = VertexAttribute<attribute::normal, 3, StorageFormat::Octahedral>;
+    using PackedTangent = VertexAttribute<attribute::tangent, 4, StorageFormat::Snorm16>;
+
+    /**
+     * @brief 带纹理坐标的模型经VertexGenerator补全法线与切线, 再由storageFormatInit打包后的顶点结构
+     * @details 纹理坐标全部落在[0, 1]时为UnitVertex, 否则纹理坐标保持float, 为TiledVertex; 其余结构按运行时布局处理
+     */
+    using UnitVertex = StaticVertexLayout<PackedPosition, UnitTexCoord, PackedNormal, PackedTangent>;
+    using TiledVertex = StaticVertexLayout<PackedPosition, attribute::TexCoord, PackedNormal, PackedTangent>;
+
+    static_assert(UnitVertex::stride == 24, "half坐标4分量8字节, unorm16纹理坐标4字节, 八面体法线4字节, snorm16切线8字节");
+    static_assert(UnitVertex::offset<PackedPosition> == 0 && UnitVertex::offset<UnitTexCoord> == 8
+        && UnitVertex::offset<PackedNormal> == 12 && UnitVertex::offset<PackedTangent> == 16);
+    static_assert(UnitVertex::location<UnitTexCoord> == 1, "与vertex.glsl中aTexCoord的location一致");
+    static_assert(TiledVertex::stride == 28);
+    static_assert(TiledVertex::offset<attribute::TexCoord> == 8 && TiledVertex::offset<PackedNormal> == 16 && TiledVertex::offset<PackedTangent> == 20);
+    static_assert(TiledVertex::location<attribute::TexCoord> == 1, "与vertex.glsl中aTexCoord的location一致");
+
+    /**
+     * @brief 获取布局上传结构的格式描述
+     * @details Interleaved模式下常见结构的格式由编译期布局给出, 其余结构与Separate模式按运行时布局给出
+     * @param layout 缓冲区组装布局
+     * @return 顶点格式描述
+     */
+    VertexFormatDescriptor formatOf(const VertexLayout<float>& layout) {
+        if (layout.streamMode() == StreamMode::Interleaved) {
+            if (UnitVertex::matches(layout)) return UnitVertex::formatDescriptor();
+            if (TiledVertex::matches(layout)) return TiledVertex::formatDescriptor();
+        }
+        return layout.formatDescriptor();
+    }
+}
+
 Model::Model(const std::string &name, Node<Transform>& modelTransformNode , VertexLayout<float> modelVertices, const EventBus& ebus):
     _name(name),
-    vertexShader(Shader(Shader::Vertex, resource::utils::readFileToStr(vertexPath))),
-    fragmentShader(Shader(Shader::Fragment, resource::utils::readFileToStr(fragmentPath))),
     _modelVertices(std::move(modelVertices)),
     _modelRootNode(modelTransformNode),
     _modelInitTransform(_modelRootNode.addChild("ModelInitTransform")),
@@ -27,25 +68,46 @@ Model::Model(const std::string &name, Node<Transform>& modelTransformNode , Vert
 }
 
 Model::~Model() {
-    glDeleteBuffers(1, &vbo);
-    glDeleteBuffers(1, &ebo);
-    glDeleteVertexArrays(1, &vao);
+    GeometryStore::shared().release(_geometry);
+    VertexArrayCache& arrays = VertexArrayCache::shared();
+    arrays.detach(vbo);
+    arrays.detach(ebo);
+    for (GLuint stream : _streams) {
+        arrays.detach(stream);
+    }
+    GLState& state = GLState::shared();
+    state.deleteBuffers(1, &vbo);
+    state.deleteBuffers(1, &ebo);
+    state.deleteBuffers(static_cast<GLsizei>(_streams.size()), _streams.data());
+    state.deleteVertexArrays(1, &vao);
 }
 
 void Model::init() {
-    vv = _modelVertices.ExpandIndices();
-    vi = _modelVertices.bufferOfIndices();
+    prepare(_modelVertices);
+    const auto& vertices = _modelVertices.WeldIndices();
+    if (const auto& weld = _modelVertices.weldStatistics(); weld.corners != 0) {
+        glog.log<DefaultLevel::Debug>(_name + " 顶点焊接: " + to_string(weld.corners) + " -> " + to_string(weld.vertices)
+            + " (" + to_string(static_cast<int>(weld.ratio() * 100.0)) + "%)");
+    }
 
-    glGenVertexArrays(1, &vao);
-    glBindVertexArray(vao);
-    glGenBuffers(1, &vbo);
-    glGenBuffers(1, &ebo);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER,   vv.size() * sizeof(float), vv.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, vi.size() * sizeof(unsigned int), vi.data(), GL_STATIC_DRAW);
+    vector<unsigned char> indexData = _modelVertices.packIndices();
+    _indexType = _modelVertices.indexType();
+    _indexCount = static_cast<GLsizei>(_modelVertices.bufferOfIndices().size());
 
-    _modelVertices.bufferLayoutDeclaration();
+    // 交错顶点放入共享几何存储, 与同格式的模型共用缓冲区, 绘制由DrawBatch合并提交
+    if (_modelVertices.streamMode() == StreamMode::Interleaved && !_modelVertices.elements().empty()) {
+        vector<unsigned char> vertexData = _modelVertices.packBuffer();
+        _geometry = GeometryStore::shared().allocate(formatOf(_modelVertices), _indexType,
+            vertexData.data(), vertexData.size() / _modelVertices.elements()[0].packedStep,
+            indexData.data(), _modelVertices.bufferOfIndices().size());
+        if (_geometry.isValid()) {
+            glog.log<DefaultLevel::Debug>(_name + " 顶点数据: " + to_string(vertices.size() * sizeof(float)) + " -> " + to_string(vertexData.size())
+                + " 字节, 索引: " + (_indexType == GL_UNSIGNED_SHORT ? "16" : "32") + "位, 几何池: " + to_string(_geometry.pool));
+        }
+    }
+    if (!_geometry.isValid()) {
+        bufferInit(indexData);
+    }
 
     transformInit();
 
@@ -55,15 +117,123 @@ void Model::init() {
         }
     });
 
+    _ebus.subscribe<FrameSize_Event>("frame-size-callback", [this](const FrameSize_Event& content) {
+        this->_viewportHeight = static_cast<float>(content.height == 0 ? 1 : content.height);
+    });
+
     // if (_name == "GUI") {
     //     _ebus.subscribe<FrameSize_Event>("frame-size-callback", [this](const FrameSize_Event& content) {
     //         _modelRootNode.get().setScale({, 1.0f});
     //     });
     // }
 
-    program.attach(vertexShader);
-    program.attach(fragmentShader);
-    (void) program.link();
+    // 源码相同的模型共享同一着色器程序, 只在首个模型初始化时编译链接或从程序二进制缓存装载
+    ShaderCache& shaders = ShaderCache::shared();
+    const MappedFile vertexSource = resource::utils::mapFile(vertexPath);
+    const MappedFile fragmentSource = resource::utils::mapFile(fragmentPath);
+    program = shaders.program({{Shader::Vertex, vertexSource.view()}, {Shader::Fragment, fragmentSource.view()}});
+    const auto& statistics = shaders.statistics();
+    glog.log<DefaultLevel::Debug>(_name + " 着色器缓存: 编译" + to_string(statistics.compiles) + "次 ("
+        + to_string(statistics.compileMilliseconds) + "ms), 命中" + to_string(statistics.shaderHits) + "次; 链接"
+        + to_string(statistics.links) + "次 (" + to_string(statistics.linkMilliseconds) + "ms), 命中"
+        + to_string(statistics.programHits) + "次; 二进制装载" + to_string(statistics.binaryLoads) + "次 ("
+        + to_string(statistics.binaryMilliseconds) + "ms)");
+}
+
+void Model::streamMode(StreamMode mode) {
+    if (program != nullptr) {
+        glog.log<DefaultLevel::Error>(_name + " 已上传, 不能再切换顶点流模式");
+        return;
+    }
+    _modelVertices.streamMode(mode);
+}
+
+void Model::bufferInit(const vector<unsigned char>& indexData) {
+    const auto& vertices = _modelVertices.WeldIndices();
+
+    // 支持分离式顶点格式时与同格式的模型共享顶点数组对象, 否则各自创建并声明
+    GLState& state = GLState::shared();
+    _vertexFormat = VertexArrayCache::shared().acquire(formatOf(_modelVertices));
+    const bool isShared = _vertexFormat != VertexArrayCache::invalidHandle;
+    if (!isShared) {
+        glGenVertexArrays(1, &vao);
+        state.bindVertexArray(vao);
+    }
+    glGenBuffers(1, &ebo);
+
+    if (_modelVertices.streamMode() == StreamMode::Separate) {
+        _streams.resize(_modelVertices.elements().size());
+        glGenBuffers(static_cast<GLsizei>(_streams.size()), _streams.data());
+        size_t vertexBytes{};
+        for (size_t i = 0; i < _streams.size(); i++) {
+            vector<unsigned char> streamData = _modelVertices.packStream(i);
+            vertexBytes += streamData.size();
+            state.bindBuffer(GL_ARRAY_BUFFER, _streams[i]);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(streamData.size()), streamData.data(), GL_STATIC_DRAW);
+            if (!isShared) {
+                _modelVertices.streamDeclaration(i);
+            }
+        }
+        glog.log<DefaultLevel::Debug>(_name + " 顶点数据: " + to_string(vertices.size() * sizeof(float)) + " -> " + to_string(vertexBytes)
+            + " 字节, " + to_string(_streams.size()) + "个顶点流, 索引: " + (_indexType == GL_UNSIGNED_SHORT ? "16" : "32") + "位");
+    } else {
+        glGenBuffers(1, &vbo);
+        vector<unsigned char> vertexData = _modelVertices.packBuffer();
+        glog.log<DefaultLevel::Debug>(_name + " 顶点数据: " + to_string(vertices.size() * sizeof(float)) + " -> " + to_string(vertexData.size())
+            + " 字节, 索引: " + (_indexType == GL_UNSIGNED_SHORT ? "16" : "32") + "位");
+        state.bindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexData.size()), vertexData.data(), GL_STATIC_DRAW);
+        if (!isShared) {
+            // 几何存储分配失败且不支持分离式顶点格式时才会到此, 常见结构同样以编译期布局声明
+            if (UnitVertex::matches(_modelVertices)) {
+                UnitVertex::declare();
+            } else if (TiledVertex::matches(_modelVertices)) {
+                TiledVertex::declare();
+            } else {
+                _modelVertices.bufferLayoutDeclaration();
+            }
+        }
+    }
+    bindVertexArray();
+    state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(indexData.size()), indexData.data(), GL_STATIC_DRAW);
+}
+
+void Model::prepare(VertexLayout<float>& layout) {
+    if (!layout.isPacked()) {
+        storageFormatInit(layout);
+    }
+    (void) layout.WeldIndices();
+    if (layout.bounds().isEmpty() || layout.sphere().isEmpty()) {
+        layout.computeBounds();
+    }
+}
+
+void Model::storageFormatInit(VertexLayout<float>& layout) {
+    if (layout.contain("vertices")) {
+        layout.storageFormat("vertices", StorageFormat::Half);
+    }
+    if (layout.contain("texCoord")) {
+        // 仅在纹理坐标全部落在[0, 1]时使用unorm16, 以免平铺纹理被截断
+        const auto& e = layout["texCoord"];
+        const vector<float>& buffer = layout.assembled();
+        const size_t stride = e.step / sizeof(float);
+        bool isUnit{true};
+        for (size_t i = e.origin / sizeof(float); isUnit && i + e.length <= buffer.size(); i += stride) {
+            for (size_t k = 0; k < e.length; k++) {
+                if (buffer[i + k] < 0.0f || buffer[i + k] > 1.0f) isUnit = false;
+            }
+        }
+        if (isUnit) {
+            layout.storageFormat("texCoord", StorageFormat::Unorm16);
+        }
+    }
+    if (layout.contain("normal")) {
+        layout.storageFormat("normal", StorageFormat::Octahedral);
+    }
+    if (layout.contain("tangent")) {
+        layout.storageFormat("tangent", StorageFormat::Snorm16);
+    }
 }
 
 void Model::transformInit() {
@@ -102,13 +272,177 @@ void Model::transformInit() {
 }
 
 void Model::render(double delta, const glm::mat4 &projection, const glm::mat4 &camera) {
+    if (_geometry.isValid()) {
+        DrawBatch batch{};
+        GLuint texture = GLState::shared().texture(0, GL_TEXTURE_2D);
+        if (texture == GLState::unknown) {
+            GLint bound{};
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+            texture = static_cast<GLuint>(bound);
+        }
+        (void) record(batch, projection, camera, texture);
+        batch.submit(GeometryStore::shared());
+        return;
+    }
+
+    const glm::mat4 world = Transform::worldMatrix(transformChain());
+    GLState::shared().useProgram(*program);
+    bindVertexArray();
+    if (_modelVertices.isUploadPending()) {
+        vertexUpload();
+    }
+    GeometryStore::setTransform(projection * camera * world);
 
+    drawRanges(projection, camera, world);
+    if (_drawCounts.empty()) return;
+    const size_t indexSize = _indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
+    if (_drawCounts.size() == 1) {
+        glDrawElements(GL_TRIANGLES, _drawCounts[0], _indexType, reinterpret_cast<void*>(_drawFirsts[0] * indexSize));
+        return;
+    }
+    _drawOffsets.clear();
+    for (size_t first : _drawFirsts) {
+        _drawOffsets.push_back(reinterpret_cast<const void*>(first * indexSize));
+    }
+    glMultiDrawElements(GL_TRIANGLES, _drawCounts.data(), _indexType, _drawOffsets.data(), static_cast<GLsizei>(_drawCounts.size()));
+}
+
+bool Model::record(DrawBatch& batch, const glm::mat4 &projection, const glm::mat4 &camera, GLuint texture) {
+    if (!_geometry.isValid()) return false;
+    if (_modelVertices.isUploadPending()) {
+        vertexUpload();
+    }
+
+    const glm::mat4 world = Transform::worldMatrix(transformChain());
+    drawRanges(projection, camera, world);
+    if (_drawCounts.empty()) return true;
+    const size_t transform = batch.transform(projection * camera * world);
+    const float depth = glm::length(glm::vec3(camera * world * glm::vec4(_modelVertices.sphere().center(), 1.0f)));
+    for (size_t i = 0; i < _drawCounts.size(); i++) {
+        batch.draw(*program, texture, _geometry, _drawFirsts[i], static_cast<size_t>(_drawCounts[i]), transform, depth);
+    }
+    return true;
+}
+
+void Model::drawRanges(const glm::mat4 &projection, const glm::mat4 &camera, const glm::mat4 &world) {
+    GLsizei indexCount = _indexCount;
+    size_t firstIndex{0};
+    if (const auto& lods = _modelVertices.lods(); !lods.empty()) {
+        _lodLevel = lodSelect(projection, camera, world);
+        indexCount = static_cast<GLsizei>(lods[_lodLevel].indexCount);
+        firstIndex = lods[_lodLevel].indexOffset;
+    }
+
+    if (_lodLevel != 0 || _modelVertices.meshlets().empty()) {
+        _drawCounts.assign(1, indexCount);
+        _drawFirsts.assign(1, firstIndex);
+        return;
+    }
+    meshletCull(projection, camera * world, worldScale(world));
+}
+
+void Model::bindVertexArray() {
+    if (_vertexFormat == VertexArrayCache::invalidHandle) {
+        GLState::shared().bindVertexArray(vao);
+        return;
+    }
+    if (_streams.empty()) {
+        const GLuint buffer = vbo;
+        VertexArrayCache::shared().bind(_vertexFormat, &buffer, 1, ebo);
+        return;
+    }
+    VertexArrayCache::shared().bind(_vertexFormat, _streams.data(), _streams.size(), ebo);
+}
+
+void Model::vertexUpload() {
+    if (_geometry.isValid()) {
+        const GeometryStore& store = GeometryStore::shared();
+        GLState::shared().bindBuffer(GL_COPY_WRITE_BUFFER, store.vertexBuffer(_geometry.pool));
+        _modelVertices.bufferSubData(GL_COPY_WRITE_BUFFER, store.vertexOffset(_geometry));
+        return;
+    }
+    if (_modelVertices.streamMode() == StreamMode::Separate) {
+        for (size_t i = 0; i < _streams.size(); i++) {
+            if (_modelVertices.uploadRanges(i).empty()) continue;
+            GLState::shared().bindBuffer(GL_ARRAY_BUFFER, _streams[i]);
+            _modelVertices.streamSubData(i, GL_ARRAY_BUFFER);
+        }
+        return;
+    }
+    GLState::shared().bindBuffer(GL_ARRAY_BUFFER, vbo);
+    _modelVertices.bufferSubData(GL_ARRAY_BUFFER);
+}
+
+void Model::meshletCull(const glm::mat4 &projection, const glm::mat4 &modelView, float scale) {
+    _drawCounts.clear();
+    _drawFirsts.clear();
+    // 在视图空间中测试, 观察点即原点
+    const Frustum frustum = Frustum::fromMatrix(projection);
+    size_t end{~size_t{0}};
+    // 锥轴由法线求得, 需以法线矩阵(逆转置)变换才能在非均匀缩放下保持与表面垂直
+    const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelView)));
+    for (const auto& meshlet : _modelVertices.meshlets()) {
+        glm::vec3 center(modelView * glm::vec4(meshlet.center, 1.0f));
+        float radius = meshlet.radius * scale;
+        if (!frustum.intersects(center, radius)) continue;
+        if (_isConeCull && meshlet.coneCutoff < 1.0f) {
+            glm::vec3 axis = glm::normalize(normalMatrix * meshlet.coneAxis);
+            if (glm::dot(center, axis) >= meshlet.coneCutoff * glm::length(center) + radius) continue;
+        }
+
+        // 索引上相邻的可见簇合并为一次绘制
+        if (meshlet.indexOffset == end) {
+            _drawCounts.back() += static_cast<GLsizei>(meshlet.indexCount);
+        } else {
+            _drawCounts.push_back(static_cast<GLsizei>(meshlet.indexCount));
+            _drawFirsts.push_back(meshlet.indexOffset);
+        }
+        end = meshlet.indexOffset + meshlet.indexCount;
+    }
+}
+
+const Bounds& Model::bounds() const {
+    return _modelVertices.bounds();
+}
+
+const BoundingSphere& Model::sphere() const {
+    return _modelVertices.sphere();
+}
+
+Bounds Model::worldBounds() {
+    return _modelVertices.bounds().transformed(Transform::worldMatrix(transformChain()));
+}
+
+BoundingSphere Model::worldSphere() {
+    return _modelVertices.sphere().transformed(Transform::worldMatrix(transformChain()));
+}
+
+const std::vector<std::reference_wrapper<const Transform>>& Model::transformChain() {
     if (_transformChain.empty()) {
         _transformChain = _modelInitTransform.tracebackToRoot();
     }
+    return _transformChain;
+}
 
-    program.use();
-    glBindVertexArray(vao);
-    program["Transform"].setMat4(projection * camera * Transform::worldMatrix(_transformChain));
-    glDrawElements(GL_TRIANGLES, vi.size(), GL_UNSIGNED_INT, nullptr);
+float Model::worldScale(const glm::mat4 &world) {
+    return (std::max)({glm::length(glm::vec3(world[0])), glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))});
+}
+
+size_t Model::lodSelect(const glm::mat4 &projection, const glm::mat4 &camera, const glm::mat4 &world) const {
+    const auto& lods = _modelVertices.lods();
+    const BoundingSphere& sphere = _modelVertices.sphere();
+    if (lods.size() <= 1 || sphere.isEmpty()) return 0;
+
+    float scale = worldScale(world);
+    float radius = sphere.radius() * scale;
+    glm::vec3 center(camera * world * glm::vec4(sphere.center(), 1.0f));
+    float distance = glm::length(center);
+    if (distance <= radius) return 0;
+
+    // 距离distance处每单位长度投影到屏幕上的像素数, 即包围球投影直径与其世界直径之比
+    float pixelsPerUnit = projection[1][1] * _viewportHeight * 0.5f / distance;
+    for (size_t i = lods.size() - 1; i > 0; i--) {
+        if (lods[i].error * scale * pixelsPerUnit <= _lodPixelError) return i;
+    }
+    return 0;
 }
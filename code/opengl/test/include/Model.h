@@ -1,12 +1,16 @@
 #pragma once
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include <DrawBatch.h>
 #include <EventBus.hpp>
+#include <GeometryStore.h>
 #include <Node.hpp>
 #include <ShaderProgram.h>
 #include <Transform.h>
+#include <VertexArrayCache.h>
 #include <VertexLayout.hpp>
 
 #include "ResourceTypes.hpp"
@@ -22,24 +26,199 @@ class Model {
         Model(Model&& other) = default;
         Model& operator = (Model&& other) = default;
 
+        /**
+         * @brief 上传至GPU并完成初始化
+         * @details 须在渲染线程调用; 未经prepare的布局会在此处补做准备.
+         *          Interleaved模式的布局上传到GeometryStore, 与同格式的模型共用缓冲区;
+         *          布局为StreamMode::Separate时每个元素各上传到一个缓冲区
+         */
         void init();
+
+        /**
+         * @brief 上传前的CPU准备
+         * @details 选择存储格式, 焊接组装并补算包围体; 不调用opengl, 可在工作线程上执行
+         * @param layout 缓冲区组装布局
+         */
+        static void prepare(VertexLayout<float>& layout);
+
+        /**
+         * @brief 选择各属性的存储格式
+         * @details 他似乎不需要详细注释[划掉]
+         * @param layout 缓冲区组装布局
+         */
+        static void storageFormatInit(VertexLayout<float>& layout);
         void transformInit();
+
+        /**
+         * @brief 绘制模型
+         * @details 使用0号纹理单元当前绑定的纹理, 程序与顶点数组对象经GLState绑定; 位于GeometryStore的模型以单独的DrawBatch立即提交, 多个模型应改用record合并提交
+         * @param delta 帧间隔
+         * @param projection 投影矩阵
+         * @param camera 视图矩阵
+         */
         void render(double delta, const glm::mat4& projection, const glm::mat4& camera);
+
+        /**
+         * @brief 将本帧的绘制记录到合并提交中
+         * @details 选择细节层级并进行簇剔除, 局部更新过的顶点在此处上传; 以包围球中心到摄像机的距离作为排序深度
+         * @param batch 本趟绘制的合并提交
+         * @param projection 投影矩阵
+         * @param camera 视图矩阵
+         * @param texture 绘制时绑定的纹理
+         * @return 模型不在GeometryStore中时为false, 此时需调用render
+         */
+        bool record(DrawBatch& batch, const glm::mat4& projection, const glm::mat4& camera, GLuint texture);
+
+        /**
+         * @brief 按投影后的屏幕尺寸选择细节层级
+         * @details 选择投影误差不超过_lodPixelError像素的最粗层级; 摄像机位于包围球内时总是使用最细层级
+         * @param projection 投影矩阵
+         * @param camera 视图矩阵
+         * @param world 模型世界矩阵
+         * @return 细节层级下标
+         */
+        [[nodiscard]] size_t lodSelect(const glm::mat4& projection, const glm::mat4& camera, const glm::mat4& world) const;
+
+        /**
+         * @brief 绑定顶点数组对象
+         * @details 共享顶点数组对象时经VertexArrayCache绑定并更换本模型的缓冲区, 否则绑定本模型的顶点数组对象
+         */
+        void bindVertexArray();
+
+        /**
+         * @brief 上传局部更新过的顶点
+         * @details 位于GeometryStore时写入所在池的顶点缓冲区中本模型的区段; 否则Interleaved模式下写入vbo, Separate模式下只写入被修改元素的顶点流
+         */
+        void vertexUpload();
+
+        /**
+         * @brief 选择本帧绘制的索引区间
+         * @details 选择细节层级, 最细层级且有簇时进行簇剔除; 结果写入_drawCounts与_drawFirsts
+         * @param projection 投影矩阵
+         * @param camera 视图矩阵
+         * @param world 模型世界矩阵
+         */
+        void drawRanges(const glm::mat4& projection, const glm::mat4& camera, const glm::mat4& world);
+
+        /**
+         * @brief 按簇进行CPU剔除
+         * @details 以视锥测试各簇包围球, 开启法线锥剔除时再剔除整体背向的簇; 结果写入_drawCounts与_drawFirsts
+         * @param projection 投影矩阵
+         * @param modelView 模型视图矩阵
+         * @param scale 模型世界矩阵的最大缩放
+         */
+        void meshletCull(const glm::mat4& projection, const glm::mat4& modelView, float scale);
+
+        /**
+         * @brief 配置法线锥剔除
+         * @details 仅在开启GL_CULL_FACE时才应开启, 否则会剔除仍然可见的背面
+         * @param isConeCull 是否开启
+         */
+        void coneCull(bool isConeCull) {
+            _isConeCull = isConeCull;
+        }
+
+        /**
+         * @brief 配置顶点流模式
+         * @details 须在init之前调用. 逐帧只修改部分属性(例如变形只改坐标)的模型适合Separate, 局部更新只上传被修改元素的顶点流;
+         *          Separate模式的模型不放入GeometryStore, 不参与DrawBatch合并提交
+         * @param mode 顶点流模式
+         */
+        void streamMode(StreamMode mode);
+
+        /**
+         * @brief 设置视口高度
+         * @details 用于在帧缓冲尺寸事件之后才创建的模型, 以免细节层级按默认高度选择
+         * @param height 视口高度
+         */
+        void viewportHeight(int height) {
+            _viewportHeight = static_cast<float>(height == 0 ? 1 : height);
+        }
+
+        /**
+         * @brief 局部更新顶点
+         * @details 修改已组装的顶点, 于下一次render时只上传修改过的区间; 用于变形等逐帧只改动少量顶点的场景.
+         *          布局为StreamMode::Separate时只上传被修改元素的顶点流
+         * @param identifier 元素标识符
+         * @param first 起始顶点
+         * @param values 新数据, 长度需为元素长度的倍数
+         */
+        void updateVertices(const std::string& identifier, size_t first, const std::vector<float>& values) {
+            _modelVertices.updateAssembled(identifier, first, values);
+        }
+
+        /**
+         * @brief 获取世界矩阵的最大轴缩放
+         * @details 用于将模型空间的半径与误差换算到世界空间
+         * @param world 世界矩阵
+         * @return 最大轴缩放
+         */
+        static float worldScale(const glm::mat4& world);
+
+        /**
+         * @brief 获取模型空间包围盒
+         * @details 导入时计算, 随网格缓存保存
+         * @return 包围盒引用
+         */
+        [[nodiscard]] const Bounds& bounds() const;
+
+        /**
+         * @brief 获取模型空间包围球
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 包围球引用
+         */
+        [[nodiscard]] const BoundingSphere& sphere() const;
+
+        /**
+         * @brief 获取世界空间包围盒
+         * @details 由Node<Transform>链的世界矩阵变换模型空间包围盒得到, 每次调用都按当前变换重新计算
+         * @return 包围盒
+         */
+        Bounds worldBounds();
+
+        /**
+         * @brief 获取世界空间包围球
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 包围球
+         */
+        BoundingSphere worldSphere();
     private:
         std::string _name;
         VertexArrays vao{};
         BufferObject vbo{};
         BufferObject ebo{};
-        Shader vertexShader;
-        Shader fragmentShader;
-        ShaderProgram program;
+        std::vector<GLuint> _streams;
+        VertexArrayCache::Handle _vertexFormat{VertexArrayCache::invalidHandle};
+        GeometryStore::Allocation _geometry{};
+        std::shared_ptr<ShaderProgram> program;
         VertexLayout<float> _modelVertices;
-        std::vector<float> vv;
-        std::vector<unsigned int> vi;
+        GLsizei _indexCount{};
+        GLenum _indexType{GL_UNSIGNED_INT};
+        float _viewportHeight{600.0f};
+        float _lodPixelError{1.0f};
+        size_t _lodLevel{};
+        bool _isConeCull{false};
+        std::vector<GLsizei> _drawCounts;
+        std::vector<size_t> _drawFirsts;
+        std::vector<const void*> _drawOffsets;
         Node<Transform>& _modelRootNode;
         Node<Transform>& _modelInitTransform;
         std::vector<std::reference_wrapper<const Transform>> _transformChain;
 
+        /**
+         * @brief 上传到本模型自有的缓冲区
+         * @details 用于不能放入GeometryStore的布局, 顶点数组对象按VertexArrayCache的支持情况共享或自建
+         * @param indexData 打包后的索引
+         */
+        void bufferInit(const std::vector<unsigned char>& indexData);
+
+        /**
+         * @brief 获取从根节点到本模型的变换链
+         * @details 首次调用时回溯节点树并缓存
+         * @return 变换链引用
+         */
+        const std::vector<std::reference_wrapper<const Transform>>& transformChain();
+
         const EventBus& _ebus;
         bool k{false};
         float t{0.0f};
@@ -0,0 +1,179 @@
+#include "Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEARN_BOUNDS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+#ifdef LEARN_BOUNDS_SSE2
+    float lane(__m128 value, int index) {
+        alignas(16) float out[4];
+        _mm_store_ps(out, value);
+        return out[index];
+    }
+
+    /**
+     * @brief 紧密排列坐标的min/max归约
+     * @details 每次读取4个顶点(12个浮点)到3个向量, 各向量的通道依次对应xyzx, yzxy, zxyz, 最后再按分量合并通道
+     * @return 已处理的顶点数量, 剩余不足4个的顶点由调用方处理
+     */
+    size_t reducePacked(const float* positions, size_t count, glm::vec3& minimum, glm::vec3& maximum) {
+        const size_t blocks = count / 4;
+        if (blocks == 0) return 0;
+        __m128 min0 = _mm_loadu_ps(positions), min1 = _mm_loadu_ps(positions + 4), min2 = _mm_loadu_ps(positions + 8);
+        __m128 max0 = min0, max1 = min1, max2 = min2;
+        for (size_t i = 1; i < blocks; i++) {
+            const float* p = positions + i * 12;
+            __m128 a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+            min0 = _mm_min_ps(min0, a);
+            min1 = _mm_min_ps(min1, b);
+            min2 = _mm_min_ps(min2, c);
+            max0 = _mm_max_ps(max0, a);
+            max1 = _mm_max_ps(max1, b);
+            max2 = _mm_max_ps(max2, c);
+        }
+        auto merge = [](const __m128& v0, const __m128& v1, const __m128& v2, const auto& op) {
+            return glm::vec3(
+                op(op(lane(v0, 0), lane(v0, 3)), op(lane(v1, 2), lane(v2, 1))),
+                op(op(lane(v0, 1), lane(v1, 0)), op(lane(v1, 3), lane(v2, 2))),
+                op(op(lane(v0, 2), lane(v1, 1)), op(lane(v2, 0), lane(v2, 3)))
+            );
+        };
+        minimum = merge(min0, min1, min2, [](float l, float r) { return (std::min)(l, r); });
+        maximum = merge(max0, max1, max2, [](float l, float r) { return (std::max)(l, r); });
+        return blocks * 4;
+    }
+
+    /**
+     * @brief 读取一个顶点的xyz
+     * @details xy以一次8字节读取, z单独读取, 第4通道为0; 不读取z之后的内存, 坐标位于跨度末尾时也不会越界
+     */
+    __m128 loadPosition(const float* p) {
+        const __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+        return _mm_movelh_ps(xy, _mm_load_ss(p + 2));
+    }
+
+    /**
+     * @brief 任意跨度坐标的min/max归约
+     * @details 每个顶点读取3个浮点到一个向量, 第4通道被忽略
+     * @return 已处理的顶点数量
+     */
+    size_t reduceStrided(const float* positions, size_t count, size_t stride, glm::vec3& minimum, glm::vec3& maximum) {
+        __m128 low = loadPosition(positions);
+        __m128 high = low;
+        for (size_t i = 1; i < count; i++) {
+            __m128 p = loadPosition(positions + i * stride);
+            low = _mm_min_ps(low, p);
+            high = _mm_max_ps(high, p);
+        }
+        minimum = glm::vec3(lane(low, 0), lane(low, 1), lane(low, 2));
+        maximum = glm::vec3(lane(high, 0), lane(high, 1), lane(high, 2));
+        return count;
+    }
+#endif
+}
+
+Bounds::Bounds(const glm::vec3& minimum, const glm::vec3& maximum):
+    _minimum(minimum),
+    _maximum(maximum) {}
+
+Bounds Bounds::fromPositions(const float* positions, size_t count, size_t stride) {
+    Bounds out{};
+    if (count == 0 || stride < 3) return out;
+    size_t done = 0;
+#ifdef LEARN_BOUNDS_SSE2
+    glm::vec3 minimum{}, maximum{};
+    done = stride == 3 ? reducePacked(positions, count, minimum, maximum) : reduceStrided(positions, count, stride, minimum, maximum);
+    if (done != 0) {
+        out = Bounds(minimum, maximum);
+    }
+#endif
+    for (size_t i = done; i < count; i++) {
+        const float* p = positions + i * stride;
+        out.expand({p[0], p[1], p[2]});
+    }
+    return out;
+}
+
+Bounds& Bounds::expand(const glm::vec3& point) {
+    _minimum = glm::min(_minimum, point);
+    _maximum = glm::max(_maximum, point);
+    return *this;
+}
+
+Bounds& Bounds::expand(const Bounds& other) {
+    if (other.isEmpty()) return *this;
+    _minimum = glm::min(_minimum, other._minimum);
+    _maximum = glm::max(_maximum, other._maximum);
+    return *this;
+}
+
+Bounds Bounds::transformed(const glm::mat4& matrix) const {
+    if (isEmpty()) return {};
+    glm::vec3 center(matrix * glm::vec4(this->center(), 1.0f));
+    glm::vec3 extent = this->extent();
+    glm::vec3 out{0.0f};
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            out[row] += std::abs(matrix[column][row]) * extent[column];
+        }
+    }
+    return {center - out, center + out};
+}
+
+bool Bounds::isEmpty() const {
+    return _minimum.x > _maximum.x || _minimum.y > _maximum.y || _minimum.z > _maximum.z;
+}
+
+const glm::vec3& Bounds::minimum() const {
+    return _minimum;
+}
+
+const glm::vec3& Bounds::maximum() const {
+    return _maximum;
+}
+
+glm::vec3 Bounds::center() const {
+    return (_minimum + _maximum) * 0.5f;
+}
+
+glm::vec3 Bounds::extent() const {
+    return (_maximum - _minimum) * 0.5f;
+}
+
+BoundingSphere::BoundingSphere(const glm::vec3& center, float radius):
+    _center(center),
+    _radius(radius) {}
+
+BoundingSphere BoundingSphere::fromPositions(const float* positions, size_t count, size_t stride, const glm::vec3& center) {
+    if (count == 0) return {};
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        const float* p = positions + i * stride;
+        float x = p[0] - center.x, y = p[1] - center.y, z = p[2] - center.z;
+        radius2 = (std::max)(radius2, x * x + y * y + z * z);
+    }
+    return {center, std::sqrt(radius2)};
+}
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4& matrix) const {
+    if (isEmpty()) return {};
+    float scale = (std::max)({glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))});
+    return {glm::vec3(matrix * glm::vec4(_center, 1.0f)), _radius * scale};
+}
+
+bool BoundingSphere::isEmpty() const {
+    return _radius < 0.0f;
+}
+
+const glm::vec3& BoundingSphere::center() const {
+    return _center;
+}
+
+float BoundingSphere::radius() const {
+    return _radius;
+}
@@ -0,0 +1,27 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+Frustum Frustum::fromMatrix(const glm::mat4& matrix) {
+    auto row = [&matrix](int i) {
+        return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+    };
+    const glm::vec4 x = row(0), y = row(1), z = row(2), w = row(3);
+
+    Frustum out{};
+    out._planes = {w + x, w - x, w + y, w - y, w + z, w - z};
+    for (auto& plane : out._planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) plane = plane / length;
+    }
+    return out;
+}
+
+bool Frustum::intersects(const glm::vec3& center, float radius) const {
+    for (const auto& plane : _planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
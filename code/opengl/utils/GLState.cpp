@@ -0,0 +1,130 @@
+#include "GLState.h"
+
+using namespace std;
+
+GLState& GLState::shared() {
+    static GLState state{};
+    return state;
+}
+
+void GLState::useProgram(GLuint program) {
+    if (!change(_program, program)) return;
+    glUseProgram(program);
+}
+
+void GLState::bindVertexArray(GLuint vertexArray) {
+    if (!change(_vertexArray, vertexArray)) return;
+    glBindVertexArray(vertexArray);
+}
+
+void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    if (unit >= _textures.size()) {
+        _textures.resize(unit + 1);
+    }
+    if (!change(find(_textures[unit], target), texture)) return;
+    if (_activeUnit != unit) {
+        _activeUnit = unit;
+        _current.issued++;
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    glBindTexture(target, texture);
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        _current.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (!change(find(_buffers, target), buffer)) return;
+    glBindBuffer(target, buffer);
+}
+
+void GLState::enable(GLenum capability) {
+    if (!change(find(_capabilities, capability), GL_TRUE)) return;
+    glEnable(capability);
+}
+
+void GLState::disable(GLenum capability) {
+    if (!change(find(_capabilities, capability), GL_FALSE)) return;
+    glDisable(capability);
+}
+
+GLuint GLState::program() const {
+    return _program;
+}
+
+GLuint GLState::texture(GLuint unit, GLenum target) const {
+    if (unit >= _textures.size()) return unknown;
+    for (const Binding& b : _textures[unit]) {
+        if (b.target == target) return b.name;
+    }
+    return unknown;
+}
+
+void GLState::deleteBuffers(GLsizei count, const GLuint* buffers) {
+    for (GLsizei i = 0; i < count; i++) {
+        forget(_buffers, buffers[i]);
+    }
+    glDeleteBuffers(count, buffers);
+}
+
+void GLState::deleteVertexArrays(GLsizei count, const GLuint* vertexArrays) {
+    for (GLsizei i = 0; i < count; i++) {
+        if (vertexArrays[i] != 0 && _vertexArray == vertexArrays[i]) _vertexArray = 0;
+    }
+    glDeleteVertexArrays(count, vertexArrays);
+}
+
+void GLState::deleteTextures(GLsizei count, const GLuint* textures) {
+    // 只有绑定在各单元上的纹理会被解除绑定, 与当前活动单元无关
+    for (GLsizei i = 0; i < count; i++) {
+        for (auto& bindings : _textures) {
+            forget(bindings, textures[i]);
+        }
+    }
+    glDeleteTextures(count, textures);
+}
+
+void GLState::invalidate() {
+    _program = unknown;
+    _vertexArray = unknown;
+    _activeUnit = unknown;
+    _textures.clear();
+    _buffers.clear();
+    _capabilities.clear();
+}
+
+void GLState::frame() {
+    _last = _current;
+    _current = {};
+}
+
+const GLState::Statistics& GLState::statistics() const {
+    return _last;
+}
+
+bool GLState::change(GLuint& recorded, GLuint value) {
+    if (recorded == value) {
+        _current.elided++;
+        return false;
+    }
+    recorded = value;
+    _current.issued++;
+    return true;
+}
+
+GLuint& GLState::find(vector<Binding>& bindings, GLenum target) {
+    for (Binding& b : bindings) {
+        if (b.target == target) return b.name;
+    }
+    bindings.push_back({target, unknown});
+    return bindings.back().name;
+}
+
+void GLState::forget(vector<Binding>& bindings, GLuint name) {
+    if (name == 0) return;
+    for (Binding& b : bindings) {
+        if (b.name == name) b.name = 0;
+    }
+}
@@ -0,0 +1,105 @@
+#include "VertexArrayCache.h"
+
+#include <cstring>
+
+#include "GLState.h"
+
+namespace {
+    bool hasExtension(const char* name) {
+        GLint count{};
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const auto* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (extension != nullptr && std::strcmp(extension, name) == 0) return true;
+        }
+        return false;
+    }
+}
+
+VertexArrayCache& VertexArrayCache::shared() {
+    static VertexArrayCache cache{};
+    return cache;
+}
+
+void VertexArrayCache::load(GLADloadproc loader) {
+    _vertexAttribFormat = nullptr;
+    _vertexAttribBinding = nullptr;
+    _bindVertexBuffer = nullptr;
+    const bool isCore = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 3);
+    if (!isCore && !hasExtension("GL_ARB_vertex_attrib_binding")) return;
+
+    // GL_ARB_vertex_attrib_binding的入口与核心版本同名, 不带后缀
+    _vertexAttribFormat = reinterpret_cast<VertexAttribFormatProc>(loader("glVertexAttribFormat"));
+    _vertexAttribBinding = reinterpret_cast<VertexAttribBindingProc>(loader("glVertexAttribBinding"));
+    _bindVertexBuffer = reinterpret_cast<BindVertexBufferProc>(loader("glBindVertexBuffer"));
+    if (!isSeparateFormat()) {
+        _vertexAttribFormat = nullptr;
+        _vertexAttribBinding = nullptr;
+        _bindVertexBuffer = nullptr;
+    }
+}
+
+bool VertexArrayCache::isSeparateFormat() const {
+    return _vertexAttribFormat != nullptr && _vertexAttribBinding != nullptr && _bindVertexBuffer != nullptr;
+}
+
+VertexArrayCache::Handle VertexArrayCache::acquire(const VertexFormatDescriptor& format) {
+    if (!isSeparateFormat()) return invalidHandle;
+    const uint64_t hash = format.hash();
+    auto [begin, end] = _lookup.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (_entries[it->second].format == format) return it->second;
+    }
+
+    Entry entry{};
+    entry.format = format;
+    glGenVertexArrays(1, &entry.vao);
+    GLState::shared().bindVertexArray(entry.vao);
+    for (const auto& a : format.attributes) {
+        _vertexAttribFormat(a.location, a.components, a.type, a.normalized, a.offset);
+        _vertexAttribBinding(a.location, a.binding);
+        glEnableVertexAttribArray(a.location);
+    }
+    entry.buffers.assign(format.strides.size(), 0);
+
+    const Handle handle = _entries.size();
+    _entries.push_back(std::move(entry));
+    _lookup.emplace(hash, handle);
+    return handle;
+}
+
+void VertexArrayCache::bind(Handle handle, const GLuint* buffers, size_t count, GLuint elementBuffer) {
+    Entry& entry = _entries[handle];
+    GLState::shared().bindVertexArray(entry.vao);
+    for (size_t i = 0; i < count && i < entry.buffers.size(); i++) {
+        if (entry.buffers[i] == buffers[i]) continue;
+        _bindVertexBuffer(static_cast<GLuint>(i), buffers[i], 0, entry.format.strides[i]);
+        entry.buffers[i] = buffers[i];
+    }
+    if (entry.elementBuffer != elementBuffer) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+        entry.elementBuffer = elementBuffer;
+    }
+}
+
+void VertexArrayCache::detach(GLuint buffer) {
+    if (buffer == 0) return;
+    for (Entry& entry : _entries) {
+        for (GLuint& b : entry.buffers) {
+            if (b == buffer) b = 0;
+        }
+        if (entry.elementBuffer == buffer) entry.elementBuffer = 0;
+    }
+}
+
+void VertexArrayCache::clear() {
+    for (Entry& entry : _entries) {
+        GLState::shared().deleteVertexArrays(1, &entry.vao);
+    }
+    _entries.clear();
+    _lookup.clear();
+}
+
+size_t VertexArrayCache::size() const {
+    return _entries.size();
+}
@@ -0,0 +1,117 @@
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <Hash.hpp>
+
+namespace {
+    float signNotZero(float value) {
+        return value >= 0.0f ? 1.0f : -1.0f;
+    }
+
+    template<typename U>
+    void store(unsigned char* out, size_t index, U value) {
+        std::memcpy(out + index * sizeof(U), &value, sizeof(U));
+    }
+}
+
+void VertexFormat::pack(StorageFormat format, const float* source, size_t length, unsigned char* out) {
+    std::memset(out, 0, packedSize(format, length));
+    switch (format) {
+        case StorageFormat::Float: {
+            std::memcpy(out, source, length * sizeof(float));
+            break;
+        }
+        case StorageFormat::Half: {
+            for (size_t i = 0; i < length; i++) store(out, i, toHalf(source[i]));
+            break;
+        }
+        case StorageFormat::Snorm16: {
+            for (size_t i = 0; i < length; i++) store(out, i, toSnorm16(source[i]));
+            break;
+        }
+        case StorageFormat::Unorm16: {
+            for (size_t i = 0; i < length; i++) store(out, i, toUnorm16(source[i]));
+            break;
+        }
+        case StorageFormat::Octahedral: {
+            float x = source[0], y = source[1], z = source[2];
+            float l1 = std::abs(x) + std::abs(y) + std::abs(z);
+            if (l1 == 0.0f) break;
+            x /= l1;
+            y /= l1;
+            if (z < 0.0f) {
+                float ox = (1.0f - std::abs(y)) * signNotZero(x);
+                float oy = (1.0f - std::abs(x)) * signNotZero(y);
+                x = ox;
+                y = oy;
+            }
+            store(out, 0, toSnorm16(x));
+            store(out, 1, toSnorm16(y));
+            break;
+        }
+    }
+}
+
+uint16_t VertexFormat::toHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (exponent == 0xFF) {  // 无穷与NaN
+        return sign | 0x7C00 | (mantissa != 0 ? 0x200 : 0);
+    }
+    int e = static_cast<int>(exponent) - 127 + 15;
+    if (e >= 0x1F) return sign | 0x7C00;
+    if (e <= 0) {  // 半精度非规格化数
+        if (e < -10) return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - e);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(e) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1u))) half++;  // 进位可能溢出到指数, 结果仍正确
+    return static_cast<uint16_t>(sign | half);
+}
+
+int16_t VertexFormat::toSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+uint16_t VertexFormat::toUnorm16(float value) {
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+uint64_t VertexFormatDescriptor::hash() const {
+    uint64_t out = hashing::fnv1aOffset;
+    for (const Attribute& a : attributes) {
+        const uint32_t fields[] = {a.location, static_cast<uint32_t>(a.components), a.type, a.normalized, a.offset, a.binding};
+        out = hashing::fnv1a(fields, sizeof(fields), out);
+    }
+    for (GLsizei stride : strides) {
+        out = hashing::combine(out, static_cast<uint64_t>(stride));
+    }
+    return out;
+}
+
+bool VertexFormatDescriptor::operator == (const VertexFormatDescriptor& other) const {
+    if (attributes.size() != other.attributes.size() || strides != other.strides) return false;
+    for (size_t i = 0; i < attributes.size(); i++) {
+        const Attribute& a = attributes[i];
+        const Attribute& b = other.attributes[i];
+        if (a.location != b.location || a.components != b.components || a.type != b.type
+            || a.normalized != b.normalized || a.offset != b.offset || a.binding != b.binding) {
+            return false;
+        }
+    }
+    return true;
+}
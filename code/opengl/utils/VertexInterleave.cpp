@@ -0,0 +1,116 @@
+#include "VertexInterleave.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <ThreadPool.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEARN_INTERLEAVE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+    /**
+     * @brief 定长元素拷贝
+     * @details 12字节拆为8字节向量读写与4字节标量读写, 不会越过元素边界, 因此可与相邻属性并行写入
+     */
+    template<size_t Size>
+    inline void copyElement(unsigned char* out, const unsigned char* source) {
+#ifdef LEARN_INTERLEAVE_SSE2
+        if constexpr (Size == 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+        } else if constexpr (Size == 8) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+        } else if constexpr (Size == 12) {
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+            std::memcpy(out + 8, source + 8, 4);
+        } else {
+            std::memcpy(out, source, Size);
+        }
+#else
+        std::memcpy(out, source, Size);
+#endif
+    }
+
+    template<size_t Size>
+    void scatter(unsigned char* out, size_t stride, const unsigned char* source, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            copyElement<Size>(out + i * stride, source + i * Size);
+        }
+    }
+
+    void scatter(unsigned char* out, size_t stride, const unsigned char* source, size_t size, size_t count) {
+        switch (size) {
+            case 8: scatter<8>(out, stride, source, count); return;
+            case 12: scatter<12>(out, stride, source, count); return;
+            case 16: scatter<16>(out, stride, source, count); return;
+            default: break;
+        }
+        for (size_t i = 0; i < count; i++) {
+            std::memcpy(out + i * stride, source + i * size, size);
+        }
+    }
+
+    template<size_t Size>
+    void gather(unsigned char* out, size_t stride, const unsigned char* source, const unsigned int* indices, size_t indexStride, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            copyElement<Size>(out + i * stride, source + static_cast<size_t>(indices[i * indexStride]) * Size);
+        }
+    }
+
+    void gather(unsigned char* out, size_t stride, const unsigned char* source, size_t size, const unsigned int* indices, size_t indexStride, size_t count) {
+        switch (size) {
+            case 8: gather<8>(out, stride, source, indices, indexStride, count); return;
+            case 12: gather<12>(out, stride, source, indices, indexStride, count); return;
+            case 16: gather<16>(out, stride, source, indices, indexStride, count); return;
+            default: break;
+        }
+        for (size_t i = 0; i < count; i++) {
+            std::memcpy(out + i * stride, source + static_cast<size_t>(indices[i * indexStride]) * size, size);
+        }
+    }
+
+    /**
+     * @brief 按顶点区间执行
+     * @details 顶点数量达到阈值且线程池多于一个线程时并行, 否则在调用线程上顺序执行
+     */
+    template<typename Func>
+    void forRanges(size_t vertexCount, Func&& func) {
+        const size_t rangeCount = (vertexCount + VertexInterleave::rangeSize - 1) / VertexInterleave::rangeSize;
+        auto range = [&](size_t r) {
+            const size_t begin = r * VertexInterleave::rangeSize;
+            func(begin, (std::min)(VertexInterleave::rangeSize, vertexCount - begin));
+        };
+        if (vertexCount >= VertexInterleave::parallelThreshold) {
+            ThreadPool::shared().parallelFor(rangeCount, range);
+            return;
+        }
+        for (size_t r = 0; r < rangeCount; r++) {
+            range(r);
+        }
+    }
+}
+
+void VertexInterleave::interleave(void* out, size_t stride, const Stream* streams, size_t streamCount, size_t vertexCount) {
+    auto* target = static_cast<unsigned char*>(out);
+    forRanges(vertexCount, [&](size_t begin, size_t count) {
+        for (size_t s = 0; s < streamCount; s++) {
+            const Stream& stream = streams[s];
+            scatter(target + begin * stride + stream.offset, stride,
+                static_cast<const unsigned char*>(stream.source) + begin * stream.size, stream.size, count);
+        }
+    });
+}
+
+void VertexInterleave::interleave(void* out, size_t stride, const Stream* streams, size_t streamCount, const unsigned int* indices, size_t vertexCount) {
+    auto* target = static_cast<unsigned char*>(out);
+    forRanges(vertexCount, [&](size_t begin, size_t count) {
+        for (size_t s = 0; s < streamCount; s++) {
+            const Stream& stream = streams[s];
+            gather(target + begin * stride + stream.offset, stride,
+                static_cast<const unsigned char*>(stream.source), stream.size,
+                indices + begin * streamCount + s, streamCount, count);
+        }
+    });
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief 轴对齐包围盒
+ * @details 默认构造为空包围盒, 扩展任意点后变为有效
+ */
+class Bounds {
+    public:
+        Bounds() = default;
+        Bounds(const glm::vec3& minimum, const glm::vec3& maximum);
+        ~Bounds() = default;
+
+        /**
+         * @brief 由顶点坐标计算包围盒
+         * @details 支持SSE2时以4宽向量进行min/max归约, 紧密排列(stride为3)时每次处理4个顶点
+         * @param positions 坐标数组
+         * @param count 顶点数量
+         * @param stride 相邻顶点间隔的浮点数数量
+         * @return 包围盒
+         */
+        static Bounds fromPositions(const float* positions, size_t count, size_t stride = 3);
+
+        Bounds& expand(const glm::vec3& point);
+        Bounds& expand(const Bounds& other);
+
+        /**
+         * @brief 变换包围盒
+         * @details 变换中心与半边长后重新取轴对齐包围盒, 结果包含变换后的原包围盒但可能更大
+         * @param matrix 变换矩阵
+         * @return 变换后的包围盒
+         */
+        [[nodiscard]] Bounds transformed(const glm::mat4& matrix) const;
+
+        [[nodiscard]] bool isEmpty() const;
+
+        [[nodiscard]] const glm::vec3& minimum() const;
+        [[nodiscard]] const glm::vec3& maximum() const;
+        [[nodiscard]] glm::vec3 center() const;
+        [[nodiscard]] glm::vec3 extent() const;
+    private:
+        glm::vec3 _minimum{std::numeric_limits<float>::max()};
+        glm::vec3 _maximum{std::numeric_limits<float>::lowest()};
+};
+
+/**
+ * @brief 包围球
+ * @details 默认构造为空包围球(半径为负)
+ */
+class BoundingSphere {
+    public:
+        BoundingSphere() = default;
+        BoundingSphere(const glm::vec3& center, float radius);
+        ~BoundingSphere() = default;
+
+        /**
+         * @brief 由顶点坐标计算包围球
+         * @details 以给定点(通常为包围盒中心)为球心, 半径取最远顶点的距离
+         * @param positions 坐标数组
+         * @param count 顶点数量
+         * @param stride 相邻顶点间隔的浮点数数量
+         * @param center 球心
+         * @return 包围球
+         */
+        static BoundingSphere fromPositions(const float* positions, size_t count, size_t stride, const glm::vec3& center);
+
+        /**
+         * @brief 变换包围球
+         * @details 半径按最大轴缩放放大
+         * @param matrix 变换矩阵
+         * @return 变换后的包围球
+         */
+        [[nodiscard]] BoundingSphere transformed(const glm::mat4& matrix) const;
+
+        [[nodiscard]] bool isEmpty() const;
+
+        [[nodiscard]] const glm::vec3& center() const;
+        [[nodiscard]] float radius() const;
+    private:
+        glm::vec3 _center{0.0f};
+        float _radius{-1.0f};
+};
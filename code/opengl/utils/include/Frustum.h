@@ -0,0 +1,34 @@
+#pragma once
+#include <array>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief 视锥体
+ * @details 由矩阵提取的6个平面, 法线指向视锥内侧. 平面所在空间由提取时使用的矩阵决定:
+ *          仅投影矩阵时为视图空间, 投影与视图矩阵之积时为世界空间
+ */
+class Frustum {
+    public:
+        Frustum() = default;
+        ~Frustum() = default;
+
+        /**
+         * @brief 由矩阵提取视锥体
+         * @details 他似乎不需要详细注释[划掉]
+         * @param matrix 投影矩阵或投影与视图等矩阵之积
+         * @return 视锥体
+         */
+        static Frustum fromMatrix(const glm::mat4& matrix);
+
+        /**
+         * @brief 球体是否与视锥体相交
+         * @details 保守测试, 位于视锥角落外侧附近的球体也可能返回true
+         * @param center 球心
+         * @param radius 半径
+         * @return 是否相交
+         */
+        [[nodiscard]] bool intersects(const glm::vec3& center, float radius) const;
+    private:
+        std::array<glm::vec4, 6> _planes{};
+};
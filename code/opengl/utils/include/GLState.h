@@ -0,0 +1,178 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * @brief OpenGL绑定状态的影子副本
+ * @details 记录当前着色器程序, 顶点数组对象, 各纹理单元的纹理, 各目标的缓冲区与启用开关, 与记录相同的调用直接丢弃.
+ *          状态初始为未知, 首次调用总会发出. GL_ELEMENT_ARRAY_BUFFER属于顶点数组对象的状态, 不做记录, 总是发出.
+ *          删除对象需经deleteBuffers等函数, 使记录随绑定一起恢复为0, 否则名称被复用时新对象的绑定会被误判为无需发出.
+ *          其他代码绕过本类改变绑定后需调用invalidate. 只能在渲染线程使用
+ */
+class GLState {
+    public:
+        static constexpr GLuint unknown = ~GLuint{0};
+
+        /**
+         * @brief 调用统计
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        struct Statistics {
+            size_t issued;
+            size_t elided;
+        };
+
+        /**
+         * @brief 获取共享状态
+         * @details 对应渲染线程的上下文
+         * @return 状态引用
+         */
+        static GLState& shared();
+
+        /**
+         * @brief 使用着色器程序
+         * @details 他似乎不需要详细注释[划掉]
+         * @param program 着色器程序id
+         */
+        void useProgram(GLuint program);
+
+        /**
+         * @brief 绑定顶点数组对象
+         * @details 他似乎不需要详细注释[划掉]
+         * @param vertexArray 顶点数组对象id
+         */
+        void bindVertexArray(GLuint vertexArray);
+
+        /**
+         * @brief 将纹理绑定到纹理单元
+         * @details 纹理已绑定时不切换活动纹理单元; 调用后活动纹理单元可能为unit
+         * @param unit 纹理单元序号, 从0开始
+         * @param target 纹理目标, 例如GL_TEXTURE_2D
+         * @param texture 纹理id
+         */
+        void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+        /**
+         * @brief 绑定缓冲区
+         * @details 他似乎不需要详细注释[划掉]
+         * @param target 缓冲区目标
+         * @param buffer 缓冲区id
+         */
+        void bindBuffer(GLenum target, GLuint buffer);
+
+        /**
+         * @brief 启用开关
+         * @details 他似乎不需要详细注释[划掉]
+         * @param capability 开关, 例如GL_DEPTH_TEST
+         */
+        void enable(GLenum capability);
+
+        /**
+         * @brief 禁用开关
+         * @details 他似乎不需要详细注释[划掉]
+         * @param capability 开关
+         */
+        void disable(GLenum capability);
+
+        /**
+         * @brief 获取记录的着色器程序
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 着色器程序id, 未知时为unknown
+         */
+        [[nodiscard]] GLuint program() const;
+
+        /**
+         * @brief 获取记录的纹理
+         * @details 可替代glGetIntegerv查询, 避免与驱动同步
+         * @param unit 纹理单元序号
+         * @param target 纹理目标
+         * @return 纹理id, 未知时为unknown
+         */
+        [[nodiscard]] GLuint texture(GLuint unit, GLenum target) const;
+
+        /**
+         * @brief 删除缓冲区
+         * @details 他似乎不需要详细注释[划掉]
+         * @param count 数量
+         * @param buffers 缓冲区id
+         */
+        void deleteBuffers(GLsizei count, const GLuint* buffers);
+
+        /**
+         * @brief 删除顶点数组对象
+         * @details 他似乎不需要详细注释[划掉]
+         * @param count 数量
+         * @param vertexArrays 顶点数组对象id
+         */
+        void deleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+
+        /**
+         * @brief 删除纹理
+         * @details 他似乎不需要详细注释[划掉]
+         * @param count 数量
+         * @param textures 纹理id
+         */
+        void deleteTextures(GLsizei count, const GLuint* textures);
+
+        /**
+         * @brief 将所有记录置为未知
+         * @details 上下文重建或其他代码直接改变绑定后调用
+         */
+        void invalidate();
+
+        /**
+         * @brief 结束一帧
+         * @details 本帧的统计转为上一帧的统计并清零
+         */
+        void frame();
+
+        /**
+         * @brief 获取上一帧的调用统计
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 统计引用
+         */
+        [[nodiscard]] const Statistics& statistics() const;
+
+    private:
+        struct Binding {
+            GLenum target;
+            GLuint name;
+        };
+
+        GLuint _program{unknown};
+        GLuint _vertexArray{unknown};
+        GLuint _activeUnit{unknown};
+        std::vector<std::vector<Binding>> _textures;
+        std::vector<Binding> _buffers;
+        std::vector<Binding> _capabilities;
+        Statistics _current{};
+        Statistics _last{};
+
+        /**
+         * @brief 记录是否与新值相同, 不同时更新记录
+         * @details 他似乎不需要详细注释[划掉]
+         * @param recorded 记录
+         * @param value 新值
+         * @return 是否需要发出调用
+         */
+        bool change(GLuint& recorded, GLuint value);
+
+        /**
+         * @brief 查找目标的记录
+         * @details 目标首次出现时以unknown加入
+         * @param bindings 记录数组
+         * @param target 目标
+         * @return 记录引用
+         */
+        static GLuint& find(std::vector<Binding>& bindings, GLenum target);
+
+        /**
+         * @brief 将被删除对象的记录恢复为0
+         * @details 与GL删除已绑定对象时的行为一致
+         * @param bindings 记录数组
+         * @param name 对象id
+         */
+        static void forget(std::vector<Binding>& bindings, GLuint name);
+};
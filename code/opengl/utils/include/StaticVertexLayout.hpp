@@ -0,0 +1,225 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "VertexFormat.h"
+#include "VertexLayout.hpp"
+
+/**
+ * @brief 编译期布局元素
+ * @details C++17不支持字符串字面量作为模板参数, 标识符以具有静态存储期的字符数组传入, 见attribute命名空间中的预定义标识符
+ * @tparam Identifier 元素标识符
+ * @tparam Length 元素长度
+ * @tparam Format 存储格式
+ */
+template<const char* Identifier, size_t Length, StorageFormat Format = StorageFormat::Float>
+struct VertexAttribute {
+    static_assert(Length >= 1 && Length <= 4, "元素长度需为1~4");
+    static_assert(Format != StorageFormat::Octahedral || Length == 3, "八面体编码仅支持3分量元素");
+
+    static constexpr const char* identifier = Identifier;
+    static constexpr size_t length = Length;
+    static constexpr StorageFormat format = Format;
+    static constexpr size_t size = VertexFormat::packedSize(Format, Length);
+    static constexpr GLint components = static_cast<GLint>(VertexFormat::componentCount(Format, Length));
+    static constexpr GLenum type = VertexFormat::glType(Format);
+    static constexpr bool normalized = VertexFormat::isNormalized(Format);
+};
+
+/**
+ * @brief 预定义元素
+ * @details 标识符与模型载入器生成的元素一致
+ */
+namespace attribute {
+    inline constexpr char position[] = "vertices";
+    inline constexpr char texCoord[] = "texCoord";
+    inline constexpr char normal[] = "normal";
+    inline constexpr char tangent[] = "tangent";
+
+    using Position = VertexAttribute<position, 3>;
+    using TexCoord = VertexAttribute<texCoord, 2>;
+    using Normal = VertexAttribute<normal, 3>;
+    using Tangent = VertexAttribute<tangent, 4>;
+}
+
+/**
+ * @brief 编译期缓冲区布局
+ * @details 布局以类型声明, 元素的location, 字节偏移与顶点跨度均为编译期常量, 按元素类型访问顶点不需要查找.
+ *          元素按模板参数顺序依次排列, 偏移与跨度与VertexLayout打包后的结构(packedOrigin/packedStep)一致,
+ *          因此可直接声明packBuffer的结果. 元素可选或由数据决定的布局仍使用VertexLayout::LayoutBuilder
+ * @tparam Attributes VertexAttribute元素
+ */
+template<typename... Attributes>
+class StaticVertexLayout {
+    static_assert(sizeof...(Attributes) > 0, "布局至少需要一个元素");
+
+    public:
+        static constexpr size_t count = sizeof...(Attributes);
+        static constexpr size_t stride = (Attributes::size + ...);
+
+        /**
+         * @brief 元素值类型
+         * @tparam Attribute 元素类型
+         */
+        template<typename Attribute>
+        using Value = glm::vec<static_cast<glm::length_t>(Attribute::length), float>;
+
+    private:
+        template<typename Attribute>
+        static constexpr size_t indexOf() {
+            static_assert((std::is_same_v<Attribute, Attributes> + ...) == 1, "元素在布局中不存在或重复出现");
+            constexpr bool isSame[] = {std::is_same_v<Attribute, Attributes>...};
+            size_t index{0};
+            while (!isSame[index]) index++;
+            return index;
+        }
+
+        static constexpr size_t offsetOf(size_t index) {
+            constexpr size_t sizes[] = {Attributes::size...};
+            size_t offset{0};
+            for (size_t i = 0; i < index; i++) {
+                offset += sizes[i];
+            }
+            return offset;
+        }
+
+    public:
+        /**
+         * @brief 元素位置
+         * @tparam Attribute 元素类型
+         */
+        template<typename Attribute>
+        static constexpr size_t location = indexOf<Attribute>();
+
+        /**
+         * @brief 元素在顶点内的字节偏移
+         * @tparam Attribute 元素类型
+         */
+        template<typename Attribute>
+        static constexpr size_t offset = offsetOf(location<Attribute>);
+
+        /**
+         * @brief 单个顶点
+         * @details 按布局打包的顶点字节, 可整体拷贝进顶点缓冲区
+         */
+        class Vertex {
+            public:
+                /**
+                 * @brief 写入元素
+                 * @details 按元素存储格式打包
+                 * @tparam Attribute 元素类型
+                 * @param value 元素值
+                 */
+                template<typename Attribute>
+                void set(const Value<Attribute>& value) {
+                    VertexFormat::pack(Attribute::format, &value[0], Attribute::length, _data.data() + offset<Attribute>);
+                }
+
+                /**
+                 * @brief 读取元素
+                 * @details 仅支持Float存储格式的元素
+                 * @tparam Attribute 元素类型
+                 * @return 元素值
+                 */
+                template<typename Attribute>
+                [[nodiscard]] Value<Attribute> get() const {
+                    static_assert(Attribute::format == StorageFormat::Float, "仅支持读取Float存储格式的元素");
+                    Value<Attribute> value{};
+                    std::memcpy(&value[0], _data.data() + offset<Attribute>, Attribute::size);
+                    return value;
+                }
+
+                /**
+                 * @brief 获取顶点字节
+                 * @details 他似乎不需要详细注释[划掉]
+                 * @return 首字节地址
+                 */
+                [[nodiscard]] const unsigned char* data() const {
+                    return _data.data();
+                }
+
+            private:
+                std::array<unsigned char, stride> _data{};
+        };
+
+        /**
+         * @brief 向opengl声明当前缓冲区结构
+         * @details 各元素参数均为编译期常量
+         */
+        static void declare() {
+            declare(std::index_sequence_for<Attributes...>{});
+        }
+
+        /**
+         * @brief 获取顶点格式描述
+         * @details 所有元素位于绑定点0, 与结构相同的Interleaved运行时布局的VertexLayout::formatDescriptor一致
+         * @return 顶点格式描述
+         */
+        static VertexFormatDescriptor formatDescriptor() {
+            return formatDescriptor(std::index_sequence_for<Attributes...>{});
+        }
+
+        /**
+         * @brief 获取结构相同的运行时布局构建者
+         * @details 元素的标识符, 长度与存储格式按本布局依次添加
+         * @return 构建者
+         */
+        static typename VertexLayout<float>::LayoutBuilder builder() {
+            typename VertexLayout<float>::LayoutBuilder builder{};
+            (builder.appendElement(Attributes::identifier, Attributes::length, Attributes::format), ...);
+            return builder;
+        }
+
+        /**
+         * @brief 运行时布局是否与本布局结构相同
+         * @details 逐个比较元素的标识符, 长度与存储格式, 相同时运行时布局打包后的结构与本布局一致
+         * @param layout 缓冲区组装布局
+         * @return 是否相同
+         */
+        static bool matches(const VertexLayout<float>& layout) {
+            const auto& elements = layout.elements();
+            if (elements.size() != count) return false;
+            size_t i{0};
+            return ((elements[i].identifier == Attributes::identifier
+                && elements[i].length == Attributes::length
+                && elements[i++].format == Attributes::format) && ...);
+        }
+
+    private:
+        template<size_t... Indices>
+        static VertexFormatDescriptor formatDescriptor(std::index_sequence<Indices...>) {
+            VertexFormatDescriptor out;
+            out.attributes = {{
+                static_cast<GLuint>(Indices),
+                Attributes::components,
+                Attributes::type,
+                static_cast<GLboolean>(Attributes::normalized ? GL_TRUE : GL_FALSE),
+                static_cast<GLuint>(offsetOf(Indices)),
+                0
+            }...};
+            out.strides = {static_cast<GLsizei>(stride)};
+            return out;
+        }
+
+        template<size_t... Indices>
+        static void declare(std::index_sequence<Indices...>) {
+            (declareAttribute<Attributes, Indices>(), ...);
+        }
+
+        template<typename Attribute, size_t Index>
+        static void declareAttribute() {
+            glVertexAttribPointer(Index,
+                Attribute::components,
+                Attribute::type,
+                Attribute::normalized ? GL_TRUE : GL_FALSE,
+                static_cast<GLsizei>(stride),
+                reinterpret_cast<void*>(offsetOf(Index)));
+            glEnableVertexAttribArray(Index);
+        }
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "VertexFormat.h"
+
+/**
+ * @brief 顶点数组对象缓存
+ * @details 按顶点格式共享顶点数组对象. 支持分离式顶点格式(GL 4.3或GL_ARB_vertex_attrib_binding)时,
+ *          格式在创建顶点数组对象时以glVertexAttribFormat/glVertexAttribBinding声明一次, 之后切换网格只需以glBindVertexBuffer更换缓冲区,
+ *          并跳过与各顶点数组对象当前绑定相同的调用. 不支持时isSeparateFormat为false, 调用方需退回每个网格各自的顶点数组对象.
+ *          glad只生成到GL 3.3, 分离式格式的入口在load中手动取得. 顶点数组对象经GLState绑定. 只能在渲染线程使用
+ */
+class VertexArrayCache {
+    public:
+        using Handle = size_t;
+        static constexpr Handle invalidHandle = ~size_t{0};
+
+        /**
+         * @brief 获取共享缓存
+         * @details 对应渲染线程的上下文
+         * @return 缓存引用
+         */
+        static VertexArrayCache& shared();
+
+        /**
+         * @brief 检查分离式顶点格式支持并取得入口
+         * @details 须在gladLoadGLLoader之后于渲染线程调用
+         * @param loader 函数地址查询, 例如glfwGetProcAddress
+         */
+        void load(GLADloadproc loader);
+
+        /**
+         * @brief 是否支持分离式顶点格式
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 是否支持
+         */
+        [[nodiscard]] bool isSeparateFormat() const;
+
+        /**
+         * @brief 获取格式对应的顶点数组对象
+         * @details 首次出现的格式会创建顶点数组对象并声明格式
+         * @param format 顶点格式描述
+         * @return 句柄, 不支持分离式顶点格式时为invalidHandle
+         */
+        Handle acquire(const VertexFormatDescriptor& format);
+
+        /**
+         * @brief 绑定顶点数组对象与缓冲区
+         * @details 顶点数组对象与当前相同时由GLState丢弃; 各绑定点的缓冲区与索引缓冲区只在与该顶点数组对象记录的不同时更换
+         * @param handle 句柄
+         * @param buffers 各绑定点的缓冲区, 数量需与格式的绑定点数量一致
+         * @param count 缓冲区数量
+         * @param elementBuffer 索引缓冲区
+         */
+        void bind(Handle handle, const GLuint* buffers, size_t count, GLuint elementBuffer);
+
+        /**
+         * @brief 忘记缓冲区
+         * @details 删除缓冲区前调用. 其名称可能被之后创建的缓冲区复用, 若仍记录在顶点数组对象的绑定中, 新缓冲区的绑定会被误判为无需更换
+         * @param buffer 缓冲区
+         */
+        void detach(GLuint buffer);
+
+        /**
+         * @brief 删除所有顶点数组对象
+         * @details 须在上下文销毁前于渲染线程调用
+         */
+        void clear();
+
+        /**
+         * @brief 获取缓存的格式数量
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 格式数量
+         */
+        [[nodiscard]] size_t size() const;
+
+    private:
+        using VertexAttribFormatProc = void (APIENTRYP)(GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset);
+        using VertexAttribBindingProc = void (APIENTRYP)(GLuint attribindex, GLuint bindingindex);
+        using BindVertexBufferProc = void (APIENTRYP)(GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride);
+
+        struct Entry {
+            VertexFormatDescriptor format;
+            GLuint vao{};
+            std::vector<GLuint> buffers;
+            GLuint elementBuffer{};
+        };
+
+        VertexAttribFormatProc _vertexAttribFormat{};
+        VertexAttribBindingProc _vertexAttribBinding{};
+        BindVertexBufferProc _bindVertexBuffer{};
+        std::vector<Entry> _entries;
+        std::unordered_multimap<uint64_t, Handle> _lookup;
+};
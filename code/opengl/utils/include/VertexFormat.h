@@ -0,0 +1,154 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+/**
+ * @brief 顶点属性存储格式
+ * @details Float以外的格式在上传前由VertexLayout::packBuffer打包, 每个属性按4字节对齐.
+ *          Octahedral将3分量单位法线编码为2个snorm16, 着色器中需自行解码:
+ *          vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y)); if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy); n = normalize(n);
+ */
+enum class StorageFormat {
+    Float,
+    Half,
+    Snorm16,
+    Unorm16,
+    Octahedral
+};
+
+/**
+ * @brief 顶点属性格式工具
+ * @details 他似乎不需要详细注释[划掉]
+ */
+class VertexFormat {
+    public:
+        /**
+         * @brief 获取向opengl声明的分量数量
+         * @details 他似乎不需要详细注释[划掉]
+         * @param format 存储格式
+         * @param length 源元素长度
+         * @return 分量数量
+         */
+        static constexpr size_t componentCount(StorageFormat format, size_t length) {
+            return format == StorageFormat::Octahedral ? 2 : length;
+        }
+
+        /**
+         * @brief 获取打包后的属性字节数
+         * @details 已按4字节对齐
+         * @param format 存储格式
+         * @param length 源元素长度
+         * @return 字节数
+         */
+        static constexpr size_t packedSize(StorageFormat format, size_t length) {
+            switch (format) {
+                case StorageFormat::Float: return length * sizeof(float);
+                case StorageFormat::Half:
+                case StorageFormat::Snorm16:
+                case StorageFormat::Unorm16: return (length * sizeof(uint16_t) + 3) & ~static_cast<size_t>(3);
+                case StorageFormat::Octahedral: return 2 * sizeof(int16_t);
+            }
+            return 0;
+        }
+
+        /**
+         * @brief 获取对应的opengl分量类型
+         * @details 他似乎不需要详细注释[划掉]
+         * @param format 存储格式
+         * @return opengl类型
+         */
+        static constexpr GLenum glType(StorageFormat format) {
+            switch (format) {
+                case StorageFormat::Float: return GL_FLOAT;
+                case StorageFormat::Half: return GL_HALF_FLOAT;
+                case StorageFormat::Snorm16:
+                case StorageFormat::Octahedral: return GL_SHORT;
+                case StorageFormat::Unorm16: return GL_UNSIGNED_SHORT;
+            }
+            return GL_FLOAT;
+        }
+
+        /**
+         * @brief 格式默认是否归一化
+         * @details 他似乎不需要详细注释[划掉]
+         * @param format 存储格式
+         * @return 是否归一化
+         */
+        static constexpr bool isNormalized(StorageFormat format) {
+            return format == StorageFormat::Snorm16 || format == StorageFormat::Unorm16 || format == StorageFormat::Octahedral;
+        }
+
+        /**
+         * @brief 打包单个属性
+         * @details Snorm16与Unorm16会先截断到[-1, 1]与[0, 1]; 对齐填充的字节写0
+         * @param format 存储格式
+         * @param source 源分量
+         * @param length 源元素长度
+         * @param out 输出地址, 需至少packedSize字节
+         */
+        static void pack(StorageFormat format, const float* source, size_t length, unsigned char* out);
+
+        /**
+         * @brief 单精度转半精度
+         * @details 就近舍入到偶数, 溢出为无穷
+         * @param value 单精度值
+         * @return 半精度位模式
+         */
+        static uint16_t toHalf(float value);
+
+        /**
+         * @brief 单精度转snorm16
+         * @details 他似乎不需要详细注释[划掉]
+         * @param value 单精度值, 截断到[-1, 1]
+         * @return snorm16值
+         */
+        static int16_t toSnorm16(float value);
+
+        /**
+         * @brief 单精度转unorm16
+         * @details 他似乎不需要详细注释[划掉]
+         * @param value 单精度值, 截断到[0, 1]
+         * @return unorm16值
+         */
+        static uint16_t toUnorm16(float value);
+};
+
+/**
+ * @brief 顶点格式描述
+ * @details 与缓冲区对象无关的顶点属性状态. 描述相同的网格只需更换绑定的缓冲区即可共享同一个顶点数组对象
+ */
+struct VertexFormatDescriptor {
+    /**
+     * @brief 属性格式
+     * @details offset为属性在所属绑定点的顶点内的字节偏移
+     */
+    struct Attribute {
+        GLuint location{};
+        GLint components{};
+        GLenum type{GL_FLOAT};
+        GLboolean normalized{GL_FALSE};
+        GLuint offset{};
+        GLuint binding{};
+    };
+
+    std::vector<Attribute> attributes;
+    std::vector<GLsizei> strides;
+
+    /**
+     * @brief 计算格式哈希
+     * @details 他似乎不需要详细注释[划掉]
+     * @return 哈希值
+     */
+    [[nodiscard]] uint64_t hash() const;
+
+    /**
+     * @brief 格式是否相同
+     * @details 逐项比较属性与各绑定点跨度
+     * @param other 另一格式描述
+     * @return 是否相同
+     */
+    bool operator == (const VertexFormatDescriptor& other) const;
+};
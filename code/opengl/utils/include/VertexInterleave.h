@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief 顶点属性交错
+ * @details 将各属性的紧密数据流写入交错缓冲区. 目标缓冲区由调用方一次性分配, 各属性按步长直接写入对应位置.
+ *          属性字节数为8/12/16(即2/3/4个浮点)时使用定长拷贝, 支持SSE2时以向量读写完成.
+ *          顶点按区间划分, 每个区间内依次写完所有属性, 使目标区间停留在缓存中; 顶点数量较多时区间在共享线程池上并行
+ */
+class VertexInterleave {
+    public:
+        static constexpr size_t rangeSize = 8192;
+        static constexpr size_t parallelThreshold = 65536;
+
+        /**
+         * @brief 属性数据流
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        struct Stream {
+            const void* source{};
+            size_t size{};
+            size_t offset{};
+        };
+
+        /**
+         * @brief 按顺序交错
+         * @details 第v个顶点的各属性取自各数据流的第v个元素
+         * @param out 输出地址, 需至少vertexCount * stride字节
+         * @param stride 单个顶点字节数
+         * @param streams 数据流, size为单个元素字节数, offset为元素在顶点内的字节偏移
+         * @param streamCount 数据流数量
+         * @param vertexCount 顶点数量
+         */
+        static void interleave(void* out, size_t stride, const Stream* streams, size_t streamCount, size_t vertexCount);
+
+        /**
+         * @brief 按索引交错
+         * @details 第v个顶点的第s个属性取自第s个数据流的第indices[v * streamCount + s]个元素, 索引不做越界检查
+         * @param out 输出地址, 需至少vertexCount * stride字节
+         * @param stride 单个顶点字节数
+         * @param streams 数据流
+         * @param streamCount 数据流数量
+         * @param indices 按顶点交错排列的各属性索引
+         * @param vertexCount 顶点数量
+         */
+        static void interleave(void* out, size_t stride, const Stream* streams, size_t streamCount, const unsigned int* indices, size_t vertexCount);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <string>
@@ -8,6 +9,22 @@
 #include <iostream>
 
 #include <glad/glad.h>
+#include <GlobalLogger.hpp>
+
+#include "Bounds.h"
+#include "Hash.hpp"
+#include "VertexFormat.h"
+#include "VertexInterleave.h"
+
+/**
+ * @brief 顶点流模式
+ * @details Interleaved时所有元素交错在同一个缓冲区中; Separate时每个元素各占一个缓冲区, 跨度为该元素打包后的字节数,
+ *          只需部分元素的绘制(例如仅深度的阴影绘制)可以只绑定对应的缓冲区, 局部更新也只上传被修改的元素
+ */
+enum class StreamMode {
+    Interleaved,
+    Separate
+};
 
 /**
  * @brief 缓冲区组装布局
@@ -16,6 +33,44 @@
 template<typename T>
 class VertexLayout {
     public:
+        static constexpr size_t maxUploadRanges = 16;
+
+        /**
+         * @brief 顶点区间
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        struct VertexRange {
+            size_t first{};
+            size_t count{};
+
+            /**
+             * @brief 区间是否为空
+             * @details 他似乎不需要详细注释[划掉]
+             * @return 是否为空
+             */
+            [[nodiscard]] bool isEmpty() const {
+                return count == 0;
+            }
+
+            /**
+             * @brief 合并区间
+             * @details 合并为同时覆盖两者的最小区间, 间隔较远的零散修改会合并出较大的区间
+             * @param begin 起始顶点
+             * @param size 顶点数量
+             */
+            void merge(size_t begin, size_t size) {
+                if (size == 0) return;
+                if (isEmpty()) {
+                    first = begin;
+                    count = size;
+                    return;
+                }
+                const size_t end = (std::max)(first + count, begin + size);
+                first = (std::min)(first, begin);
+                count = end - first;
+            }
+        };
+
         /**
          * @brief 布局元素
          */
@@ -27,6 +82,12 @@ class VertexLayout {
                 size_t location{};
                 size_t origin{};
                 size_t step{};
+                StorageFormat format{StorageFormat::Float};
+                bool normalized{false};
+                size_t packedOrigin{};
+                size_t packedStep{};
+                VertexRange dirtyRange{};
+                std::vector<VertexRange> _uploadRanges;
                 bool* _isDirty{};
 
                 /**
@@ -36,12 +97,15 @@ class VertexLayout {
                  * @param length 元素长度
                  * @param origin 元素原点
                  * @param location 元素位置
+                 * @param format 存储格式
                  */
-                LayoutElement(const std::string& identifier, size_t length, size_t origin, size_t location):
+                LayoutElement(const std::string& identifier, size_t length, size_t origin, size_t location, StorageFormat format = StorageFormat::Float):
                     identifier(identifier),
                     length(length),
                     location(location),
-                    origin(origin * sizeof(T)) {}
+                    origin(origin * sizeof(T)),
+                    format(format),
+                    normalized(VertexFormat::isNormalized(format)) {}
 
                 ~LayoutElement() = default;
 
@@ -77,6 +141,22 @@ class VertexLayout {
                     dirty();
                 }
 
+                /**
+                 * @brief 局部更新数据源
+                 * @details 只覆盖从first开始的values.size() / length个元素并记录到dirtyRange, 不将整个布局标记为脏.
+                 *          布局由assemblyBuffer组装时, 下次组装只重新交错脏区间内的顶点; 其余组装方式下顶点与数据源不一一对应, 仍整体重建
+                 * @param first 起始元素
+                 * @param values 新数据, 长度需为元素长度的倍数
+                 */
+                void updateSource(size_t first, const std::vector<T>& values) {
+                    const size_t count = values.size() / length;
+                    if (values.size() % length != 0 || (first + count) * length > _source.size()) {
+                        throw std::runtime_error("局部更新越界: " + identifier);
+                    }
+                    std::copy_n(values.begin(), count * length, _source.begin() + first * length);
+                    dirtyRange.merge(first, count);
+                }
+
                 /**
                  * @brief 获取当前数据源数组引用
                  * @details 他似乎不需要详细注释[划掉]
@@ -147,16 +227,18 @@ class VertexLayout {
                  * @details 他似乎不需要详细注释[划掉]
                  * @param identifier 元素标识符
                  * @param length 元素长度
+                 * @param format 存储格式
                  * @return 构建者引用
                  */
-                LayoutBuilder& appendElement(const std::string& identifier, size_t length) {
+                LayoutBuilder& appendElement(const std::string& identifier, size_t length, StorageFormat format = StorageFormat::Float) {
                     if (identifier.empty()) {
                         throw std::runtime_error("identifier为空： " + identifier);
                     }
                     if (length == 0) {
                         throw std::runtime_error("元素长度为空: " + std::to_string(length));
                     }
-                    elements.emplace_back(LayoutElement(identifier, length, originCounter, locationCounter));
+                    checkFormat(identifier, length, format);
+                    elements.emplace_back(LayoutElement(identifier, length, originCounter, locationCounter, format));
                     identifierMap.emplace(identifier, locationCounter);
                     locationCounter++;
                     originCounter += length;
@@ -227,6 +309,33 @@ class VertexLayout {
                     return *this;
                 }
 
+                /**
+                 * @brief 附加已组装完毕的缓冲区与索引
+                 * @details 用于从缓存等已组装的数据直接构建, 构建出的布局无需再次组装
+                 * @param buffer 按元素交错的缓冲区
+                 * @param indices 缓冲区索引
+                 * @return 构建者引用
+                 */
+                LayoutBuilder& attachAssembled(std::vector<T>&& buffer, std::vector<unsigned int>&& indices) {
+                    assembledBuffer = std::move(buffer);
+                    assembledIndices = std::move(indices);
+                    hasAssembled = true;
+                    return *this;
+                }
+
+                /**
+                 * @brief 附加包围体
+                 * @details 他似乎不需要详细注释[划掉]
+                 * @param bounds 包围盒
+                 * @param sphere 包围球
+                 * @return 构建者引用
+                 */
+                LayoutBuilder& attachBounds(const Bounds& bounds, const BoundingSphere& sphere = {}) {
+                    _bounds = bounds;
+                    _sphere = sphere;
+                    return *this;
+                }
+
                 /**
                  * @brief 查找构建者中是否包含元素
                  * @details 他似乎不需要详细注释[划掉]
@@ -252,13 +361,27 @@ class VertexLayout {
                     for (auto& e : elements) {
                         e.step = originCounter * sizeof(T);
                     }
-                    return VertexLayout(std::move(elements), std::move(identifierMap), std::move(rawIndices));
+                    VertexLayout layout(std::move(elements), std::move(identifierMap), std::move(rawIndices));
+                    layout.packedLayout();
+                    layout._bounds = _bounds;
+                    layout._sphere = _sphere;
+                    if (hasAssembled) {
+                        layout._cache = std::move(assembledBuffer);
+                        layout._indices = std::move(assembledIndices);
+                        layout._isDirty = false;
+                    }
+                    return layout;
                 }
 
             private:
                 std::vector<LayoutElement> elements;
                 std::map<std::string, size_t> identifierMap;
                 std::vector<unsigned int> rawIndices;
+                std::vector<T> assembledBuffer;
+                std::vector<unsigned int> assembledIndices;
+                bool hasAssembled{false};
+                Bounds _bounds{};
+                BoundingSphere _sphere{};
                 size_t locationCounter{0};
                 size_t stepCounter{0};
                 size_t originCounter{0};
@@ -295,7 +418,15 @@ class VertexLayout {
             _indices(std::move(other._indices)),
             _rawIndices(std::move(other._rawIndices)),
             _identifierMap(std::move(other._identifierMap)),
-            _isDirty(true)
+            _bounds(other._bounds),
+            _sphere(other._sphere),
+            _weldStatistics(other._weldStatistics),
+            _lods(std::move(other._lods)),
+            _meshlets(std::move(other._meshlets)),
+            _uploadRanges(std::move(other._uploadRanges)),
+            _streamMode(other._streamMode),
+            _assembly(other._assembly),
+            _isDirty(other._isDirty)
             {
                 size_t index{0};
                 for (LayoutElement& e : _layout) {
@@ -318,11 +449,18 @@ class VertexLayout {
                 _indices = std::move(other._indices);
                 _rawIndices = std::move(other._rawIndices);
                 _identifierMap = std::move(other._identifierMap);
-                _isDirty = true;
+                _bounds = other._bounds;
+                _sphere = other._sphere;
+                _weldStatistics = other._weldStatistics;
+                _lods = std::move(other._lods);
+                _meshlets = std::move(other._meshlets);
+                _uploadRanges = std::move(other._uploadRanges);
+                _streamMode = other._streamMode;
+                _assembly = other._assembly;
+                _isDirty = other._isDirty;
                 for (LayoutElement& e : _layout) {
                     e._isDirty = &this->_isDirty;
                 }
-                _isDirty = true;
             }
             return *this;
         }
@@ -337,7 +475,8 @@ class VertexLayout {
 
         /**
          * @brief 向opengl声明当前缓冲区结构
-         * @details 他似乎不需要详细注释[划掉]
+         * @details 含非Float存储格式的元素时按packBuffer的打包结构声明, 否则按组装缓冲区结构声明.
+         *          Separate模式下需改为对每个元素的缓冲区调用streamDeclaration
          */
         void bufferLayoutDeclaration() {
             if (_layout.empty()) {
@@ -348,51 +487,347 @@ class VertexLayout {
                 type = GL_FLOAT;
             }
 
+            if (!isPacked()) {
+                for (const auto& e : _layout) {
+                    glVertexAttribPointer(e.location, e.length, type, e.normalized ? GL_TRUE : GL_FALSE, e.step, reinterpret_cast<void*>(e.origin));
+                    glEnableVertexAttribArray(e.location);
+                }
+                return;
+            }
             for (const auto& e : _layout) {
-                glVertexAttribPointer(e.location, e.length, type, GL_FALSE, e.step, reinterpret_cast<void*>(e.origin));
+                glVertexAttribPointer(e.location,
+                    static_cast<GLint>(VertexFormat::componentCount(e.format, e.length)),
+                    VertexFormat::glType(e.format),
+                    e.normalized ? GL_TRUE : GL_FALSE,
+                    static_cast<GLsizei>(e.packedStep),
+                    reinterpret_cast<void*>(e.packedOrigin));
                 glEnableVertexAttribArray(e.location);
             }
         }
 
         /**
-         * @brief 通过location顺序组装缓冲区
+         * @brief 向opengl声明单个元素的缓冲区结构
+         * @details Separate模式下绑定该元素的缓冲区后调用, 结构与packStream的结果一致
+         * @param index 元素下标
+         */
+        void streamDeclaration(size_t index) const {
+            const LayoutElement& e = _layout.at(index);
+            glVertexAttribPointer(e.location,
+                static_cast<GLint>(VertexFormat::componentCount(e.format, e.length)),
+                VertexFormat::glType(e.format),
+                e.normalized ? GL_TRUE : GL_FALSE,
+                static_cast<GLsizei>(VertexFormat::packedSize(e.format, e.length)),
+                nullptr);
+            glEnableVertexAttribArray(e.location);
+        }
+
+        /**
+         * @brief 获取顶点格式描述
+         * @details 按上传结构给出: Interleaved模式下所有元素位于绑定点0, 结构与packBuffer一致; Separate模式下元素i位于绑定点i, 结构与packStream一致
+         * @return 顶点格式描述
+         */
+        VertexFormatDescriptor formatDescriptor() const {
+            VertexFormatDescriptor out;
+            const bool isSeparate = _streamMode == StreamMode::Separate;
+            for (size_t i = 0; i < _layout.size(); i++) {
+                const LayoutElement& e = _layout[i];
+                out.attributes.push_back({
+                    static_cast<GLuint>(e.location),
+                    static_cast<GLint>(VertexFormat::componentCount(e.format, e.length)),
+                    VertexFormat::glType(e.format),
+                    static_cast<GLboolean>(e.normalized ? GL_TRUE : GL_FALSE),
+                    static_cast<GLuint>(isSeparate ? 0 : e.packedOrigin),
+                    static_cast<GLuint>(isSeparate ? i : 0)
+                });
+                if (isSeparate) {
+                    out.strides.push_back(static_cast<GLsizei>(VertexFormat::packedSize(e.format, e.length)));
+                }
+            }
+            if (!isSeparate && !_layout.empty()) {
+                out.strides.push_back(static_cast<GLsizei>(_layout[0].packedStep));
+            }
+            return out;
+        }
+
+        /**
+         * @brief 获取顶点流模式
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 顶点流模式
+         */
+        StreamMode streamMode() const {
+            return _streamMode;
+        }
+
+        /**
+         * @brief 配置顶点流模式
+         * @details 只影响上传方式, 组装缓冲区仍为交错结构. 切换后等待上传的区间全部清空, 需按新模式整体上传
+         * @param mode 顶点流模式
+         */
+        void streamMode(StreamMode mode) {
+            if (_streamMode == mode) return;
+            _streamMode = mode;
+            clearUploadRanges();
+        }
+
+        /**
+         * @brief 配置元素存储格式
+         * @details 归一化标记同时重置为该格式的默认值, 需要时可再直接修改元素的normalized
+         * @param identifier 元素标识符
+         * @param format 存储格式
+         */
+        void storageFormat(const std::string& identifier, StorageFormat format) {
+            LayoutElement& e = (*this)[identifier];
+            checkFormat(identifier, e.length, format);
+            e.format = format;
+            e.normalized = VertexFormat::isNormalized(format);
+            packedLayout();
+        }
+
+        /**
+         * @brief 是否含有非Float存储格式的元素
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 是否需要打包
+         */
+        bool isPacked() const {
+            return std::any_of(_layout.begin(), _layout.end(), [](const LayoutElement& e) {
+                return e.format != StorageFormat::Float;
+            });
+        }
+
+        /**
+         * @brief 获取已组装的缓冲区
+         * @details 布局为脏时先进行焊接组装; 数据源有局部更新时先按updateSource的规则处理
+         * @return 缓冲区引用
+         */
+        const std::vector<T>& assembled() {
+            applyDirtyRanges();
+            return _isDirty ? WeldIndices() : _cache;
+        }
+
+        /**
+         * @brief 按各元素存储格式打包已组装的缓冲区
+         * @details 所有元素均为Float时结果与组装缓冲区逐字节一致
+         * @return 打包后的顶点字节流
+         */
+        std::vector<unsigned char> packBuffer() {
+            const std::vector<T>& buffer = assembled();
+            if (buffer.empty()) return {};
+            const size_t vertexCount = buffer.size() / (_layout[0].step / sizeof(T));
+            std::vector<unsigned char> out(vertexCount * _layout[0].packedStep);
+            packRange(0, vertexCount, out.data());
+            return out;
+        }
+
+        /**
+         * @brief 按各元素存储格式打包已组装缓冲区中的一段顶点
+         * @details 调用方需保证布局已组装且区间位于组装缓冲区内
+         * @param first 起始顶点
+         * @param count 顶点数量
+         * @param out 输出地址, 需至少count * packedStep字节
+         */
+        void packRange(size_t first, size_t count, void* out) const {
+            static_assert(std::is_same_v<T, float>, "仅支持float缓冲区打包");
+            const size_t stride = _layout[0].step / sizeof(T);
+            const size_t packedStep = _layout[0].packedStep;
+            auto* target = static_cast<unsigned char*>(out);
+            if (!isPacked()) {
+                std::memcpy(target, _cache.data() + first * stride, count * packedStep);
+                return;
+            }
+            for (size_t v = 0; v < count; v++) {
+                const T* vertex = _cache.data() + (first + v) * stride;
+                for (const auto& e : _layout) {
+                    VertexFormat::pack(e.format, vertex + e.origin / sizeof(T), e.length, target + v * packedStep + e.packedOrigin);
+                }
+            }
+        }
+
+        /**
+         * @brief 按存储格式打包单个元素
+         * @details 用于Separate模式, 各顶点的该元素紧密排列
+         * @param index 元素下标
+         * @return 打包后的元素字节流
+         */
+        std::vector<unsigned char> packStream(size_t index) {
+            const std::vector<T>& buffer = assembled();
+            if (buffer.empty()) return {};
+            const LayoutElement& e = _layout.at(index);
+            const size_t vertexCount = buffer.size() / (e.step / sizeof(T));
+            std::vector<unsigned char> out(vertexCount * VertexFormat::packedSize(e.format, e.length));
+            packStreamRange(index, 0, vertexCount, out.data());
+            return out;
+        }
+
+        /**
+         * @brief 按存储格式打包单个元素的一段顶点
+         * @details 调用方需保证布局已组装且区间位于组装缓冲区内
+         * @param index 元素下标
+         * @param first 起始顶点
+         * @param count 顶点数量
+         * @param out 输出地址, 需至少count * 元素打包字节数
+         */
+        void packStreamRange(size_t index, size_t first, size_t count, void* out) const {
+            static_assert(std::is_same_v<T, float>, "仅支持float缓冲区打包");
+            const LayoutElement& e = _layout.at(index);
+            const size_t stride = e.step / sizeof(T);
+            const size_t size = VertexFormat::packedSize(e.format, e.length);
+            const T* source = _cache.data() + first * stride + e.origin / sizeof(T);
+            auto* target = static_cast<unsigned char*>(out);
+            for (size_t v = 0; v < count; v++) {
+                if (e.format == StorageFormat::Float) {
+                    std::memcpy(target + v * size, source + v * stride, size);
+                } else {
+                    VertexFormat::pack(e.format, source + v * stride, e.length, target + v * size);
+                }
+            }
+        }
+
+        /**
+         * @brief 局部更新已组装的缓冲区
+         * @details 直接覆盖组装缓冲区中从first开始的顶点的一个元素, 适用于焊接或重排后与数据源不再一一对应的布局, 拓扑与索引不变.
+         *          由assemblyBuffer组装的布局会同步写回数据源; 其余布局在之后整体重建时修改会丢失. 包围体不会随之更新
+         * @param identifier 元素标识符
+         * @param first 起始顶点
+         * @param values 新数据, 长度需为元素长度的倍数
+         */
+        void updateAssembled(const std::string& identifier, size_t first, const std::vector<T>& values) {
+            applyDirtyRanges();
+            if (_isDirty) {
+                throw std::runtime_error("布局尚未组装: " + identifier);
+            }
+            LayoutElement& e = (*this)[identifier];
+            const size_t stride = e.step / sizeof(T);
+            const size_t count = values.size() / e.length;
+            if (values.size() % e.length != 0 || (first + count) * stride > _cache.size()) {
+                throw std::runtime_error("局部更新越界: " + identifier);
+            }
+            VertexInterleave::Stream stream{values.data(), e.length * sizeof(T), e.origin};
+            VertexInterleave::interleave(_cache.data() + first * stride, e.step, &stream, 1, count);
+            if (_assembly == Assembly::Sequential && (first + count) * e.length <= e._source.size()) {
+                std::copy_n(values.begin(), count * e.length, e._source.begin() + first * e.length);
+            }
+            markUpload(e, first, count);
+        }
+
+        /**
+         * @brief 获取等待上传的顶点区间
+         * @details 记录上次上传以来局部更新过的已组装顶点, 区间互不相交, 超过maxUploadRanges个时合并为一个; 整体组装后清空, 此时需整体上传.
+         *          数据源的局部更新在下次组装时才会计入. Separate模式下区间按元素记录, 此处为空
+         * @return 顶点区间数组引用
+         */
+        const std::vector<VertexRange>& uploadRanges() const {
+            return _uploadRanges;
+        }
+
+        /**
+         * @brief 获取单个元素等待上传的顶点区间
+         * @details Separate模式下使用, 规则与uploadRanges相同; Interleaved模式下为空
+         * @param index 元素下标
+         * @return 顶点区间数组引用
+         */
+        const std::vector<VertexRange>& uploadRanges(size_t index) const {
+            return _layout.at(index)._uploadRanges;
+        }
+
+        /**
+         * @brief 将等待上传的顶点写入当前绑定的缓冲区
+         * @details 以glMapBufferRange映射目标区间(GL_MAP_INVALIDATE_RANGE_BIT)后直接打包写入, 映射失败时退回glBufferSubData.
+         *          缓冲区需按packBuffer的结构完整上传过, 完成后清空上传区间
+         * @param target 缓冲区绑定目标
+         * @param base 本布局的顶点在缓冲区中的起始字节偏移, 与其他网格共享缓冲区时使用
+         */
+        void bufferSubData(GLenum target = GL_ARRAY_BUFFER, GLintptr base = 0) {
+            const size_t packedStep = _layout.empty() ? 0 : _layout[0].packedStep;
+            subData(target, _uploadRanges, packedStep, base, [this](size_t first, size_t count, void* out) {
+                packRange(first, count, out);
+            });
+        }
+
+        /**
+         * @brief 将单个元素等待上传的顶点写入当前绑定的缓冲区
+         * @details Separate模式下使用, 写入方式与bufferSubData相同, 完成后清空该元素的上传区间
+         * @param index 元素下标
+         * @param target 缓冲区绑定目标
+         */
+        void streamSubData(size_t index, GLenum target = GL_ARRAY_BUFFER) {
+            LayoutElement& e = _layout.at(index);
+            subData(target, e._uploadRanges, VertexFormat::packedSize(e.format, e.length), 0, [this, index](size_t first, size_t count, void* out) {
+                packStreamRange(index, first, count, out);
+            });
+        }
+
+        /**
+         * @brief 是否有等待上传的顶点
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 布局或任一元素的上传区间不为空时为true
+         */
+        bool isUploadPending() const {
+            return !_uploadRanges.empty() || std::any_of(_layout.begin(), _layout.end(), [](const LayoutElement& e) {
+                return !e._uploadRanges.empty();
+            });
+        }
+
+        /**
+         * @brief 获取索引类型
+         * @details 顶点数少于65536时使用16位索引
+         * @return GL_UNSIGNED_SHORT或GL_UNSIGNED_INT
+         */
+        GLenum indexType() {
+            const std::vector<T>& buffer = assembled();
+            const size_t vertexCount = _layout.empty() ? 0 : buffer.size() / (_layout[0].step / sizeof(T));
+            return vertexCount < 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+
+        /**
+         * @brief 按indexType打包索引
          * @details 他似乎不需要详细注释[划掉]
+         * @return 打包后的索引字节流
+         */
+        std::vector<unsigned char> packIndices() {
+            GLenum type = indexType();
+            std::vector<unsigned char> out;
+            if (type == GL_UNSIGNED_INT) {
+                out.resize(_indices.size() * sizeof(unsigned int));
+                std::memcpy(out.data(), _indices.data(), out.size());
+                return out;
+            }
+            out.resize(_indices.size() * sizeof(uint16_t));
+            for (size_t i = 0; i < _indices.size(); i++) {
+                auto index = static_cast<uint16_t>(_indices[i]);
+                std::memcpy(out.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+            }
+            return out;
+        }
+
+        /**
+         * @brief 通过location顺序组装缓冲区
+         * @details 第v个顶点取各元素数据源的第v个元素, 顶点数量取各数据源可容纳的最小值; 交错由VertexInterleave完成
+         *          布局不为脏且上次以同一方式组装时直接返回缓存, 否则重新组装
          * @return 缓冲区引用
          */
         const std::vector<T>& assemblyBuffer() {
-            if (!_isDirty) {
+            applyDirtyRanges();
+            if (!_isDirty && _assembly == Assembly::Sequential) {
                 return _cache;
             }
-            size_t size{};
+            size_t vertexCount = _layout.empty() ? 0 : _layout[0]._source.size() / _layout[0].length;
             for (const auto& e : _layout) {
-                size += e._source.size();
+                vertexCount = (std::min)(vertexCount, e._source.size() / e.length);
             }
+            const size_t stride = _layout.empty() ? 0 : _layout[0].step / sizeof(T);
             _cache.clear();
-            _cache.reserve(size);
-            _indices.clear();
-            _indices.reserve(size);
-
-            std::cout << "size: " << size << std::endl;
-            size_t stepCounter{};
-            size_t indexCounter{};
-            size_t i{};
-            while (true) {
-                for (auto& e : _layout) {
-                    _cache.insert(_cache.end(), e.length, 0);
-                    std::copy_n(e._source.begin() + (e.length * stepCounter),
-                    e.length,
-                    _cache.begin() + i
-                    );
-                    i += e.length;
-                }
-                stepCounter++;
-                _indices.push_back(indexCounter);
-                indexCounter++;
-                if (i >= size) break;
-            }
-
-            std::cout << "out: " << std::endl;
-            _isDirty = false;
+            _cache.resize(vertexCount * stride);
+            _indices.resize(vertexCount);
+            _lods.clear();
+            _meshlets.clear();
+
+            std::vector<VertexInterleave::Stream> streams = interleaveStreams();
+            VertexInterleave::interleave(_cache.data(), stride * sizeof(T), streams.data(), streams.size(), vertexCount);
+            for (size_t i = 0; i < vertexCount; i++) {
+                _indices[i] = static_cast<unsigned int>(i);
+            }
+
+            clean(Assembly::Sequential);
             return _cache;
         }
 
@@ -421,55 +856,156 @@ class VertexLayout {
 
         /**
          * @brief 通过索引组装缓冲区
-         * @details 他似乎不需要详细注释[划掉]
+         * @details 原始索引按面角依次给出各元素的索引, 每个面角展开为一个顶点; 交错由VertexInterleave完成
+         *          布局不为脏且上次以同一方式组装时直接返回缓存, 否则重新组装
          * @return 缓冲区引用
          */
         const std::vector<T>& ExpandIndices() {
-            if (!_isDirty) {
+            applyDirtyRanges();
+            if (!_isDirty && _assembly == Assembly::Expanded) {
                 return _cache;
             }
-            if (_rawIndices.empty()) {
-                std::cerr << "错误: 索引为空" << std::endl;
+            if (_layout.empty() || _rawIndices.empty()) {
+                glog.log<DefaultLevel::Error>(_layout.empty() ? "错误: 布局没有任何元素" : "错误: 索引为空");
                 return _cache;
             }
 
-            if (_rawIndices.empty()) {
-                std::cerr << "错误: 顶点索引为空" << std::endl;
+            const size_t stride = _layout[0].step / sizeof(T);
+            const size_t corners = _rawIndices.size() / _layout.size();
+            _cache.clear();
+            _cache.resize(corners * stride);
+            _indices.resize(corners);
+            _lods.clear();
+            _meshlets.clear();
+
+            std::vector<VertexInterleave::Stream> streams = interleaveStreams();
+            VertexInterleave::interleave(_cache.data(), stride * sizeof(T), streams.data(), streams.size(), _rawIndices.data(), corners);
+            for (size_t i = 0; i < corners; i++) {
+                _indices[i] = static_cast<unsigned int>(i);
+            }
+
+            clean(Assembly::Expanded);
+            return _cache;
+        }
+
+        /**
+         * @brief 顶点焊接统计
+         * @details corners为面角数量, 即展开组装时的顶点数; vertices为焊接后的唯一顶点数
+         */
+        struct WeldStatistics {
+            size_t corners{};
+            size_t vertices{};
+
+            /**
+             * @brief 去重率
+             * @details 他似乎不需要详细注释[划掉]
+             * @return 唯一顶点数与面角数之比, 越小去重效果越好
+             */
+            [[nodiscard]] double ratio() const {
+                return corners == 0 ? 1.0 : static_cast<double>(vertices) / static_cast<double>(corners);
+            }
+        };
+
+        /**
+         * @brief 细节层级
+         * @details 各层级共享同一顶点缓冲区, 索引依次拼接在组装索引中.
+         *          error为该层级相对原网格的几何误差, 单位与顶点坐标相同
+         */
+        struct LodLevel {
+            size_t indexOffset{};
+            size_t indexCount{};
+            float error{};
+        };
+
+        /**
+         * @brief 簇
+         * @details 最细层级索引中的一段连续三角形, 附带用于CPU剔除的包围球与法线锥.
+         *          当dot(center - eye, coneAxis) >= coneCutoff * |center - eye| + radius时簇内三角形全部背向观察点;
+         *          coneCutoff为1时表示法线过于分散, 不进行背面剔除
+         */
+        struct Meshlet {
+            size_t indexOffset{};
+            size_t indexCount{};
+            glm::vec3 center{};
+            float radius{};
+            glm::vec3 coneAxis{};
+            float coneCutoff{1.0f};
+        };
+
+        /**
+         * @brief 通过索引组装缓冲区并焊接重复顶点
+         * @details 与ExpandIndices相同地按面角组装顶点, 但以组装后的属性元组为键进行哈希去重,
+         *          缓冲区中只保留唯一顶点, 索引指向唯一顶点.
+         *          属性按位比较, 因此仅在所有元素完全一致时才会合并
+         *          布局不为脏且上次以同一方式组装时直接返回缓存, 否则重新组装
+         * @return 缓冲区引用
+         */
+        const std::vector<T>& WeldIndices() {
+            applyDirtyRanges();
+            if (!_isDirty && _assembly == Assembly::Welded) {
+                return _cache;
+            }
+            if (_layout.empty() || _rawIndices.empty()) {
+                glog.log<DefaultLevel::Error>(_layout.empty() ? "错误: 布局没有任何元素" : "错误: 索引为空");
                 return _cache;
             }
-            size_t size = (_rawIndices.size() / _layout.size()) * (_layout[0].step / sizeof(T));
+
+            const size_t elementCount = _layout.size();
+            const size_t stride = _layout[0].step / sizeof(T);
+            const size_t corners = _rawIndices.size() / elementCount;
+
+            size_t capacity{1};
+            while (capacity < corners * 2) capacity <<= 1;
+            const size_t mask = capacity - 1;
+            constexpr unsigned int empty = ~0u;
+            std::vector<unsigned int> table(capacity, empty);
+
             _cache.clear();
-            _cache.reserve(size);
+            _cache.reserve(corners * stride);
             _indices.clear();
-            _indices.reserve(_rawIndices.size() / (_layout[0].step / sizeof(T)));
-
-            size_t i{};
-            size_t stepCounter{0};
-            size_t elementIndex{0};
-            size_t indexCounter{0};
-            for (const auto& index : _rawIndices) {
-                auto& e = _layout.at(elementIndex);
-                _cache.insert(_cache.end(), e.length, 0);
-                std::copy_n(e._source.begin() + (e.length * index),
-                    e.length,
-                    _cache.begin() + i
-                    );
-                i += e.length;
-                stepCounter++;
-                elementIndex++;
-                elementIndex %= _layout.size();
-
-                if (elementIndex == 0) {
-                    _indices.push_back(indexCounter);
-                    indexCounter++;
+            _lods.clear();
+            _meshlets.clear();
+            _indices.reserve(corners);
+
+            std::vector<T> vertex(stride);
+            unsigned int vertexCount{0};
+            for (size_t c = 0; c < corners; c++) {
+                size_t offset{0};
+                for (size_t ei = 0; ei < elementCount; ei++) {
+                    const auto& e = _layout[ei];
+                    std::copy_n(e._source.begin() + (e.length * _rawIndices[c * elementCount + ei]), e.length, vertex.begin() + offset);
+                    offset += e.length;
+                }
+
+                size_t slot = static_cast<size_t>(hashing::fnv1a(vertex.data(), stride * sizeof(T))) & mask;
+                while (table[slot] != empty
+                    && std::memcmp(_cache.data() + table[slot] * stride, vertex.data(), stride * sizeof(T)) != 0) {
+                    slot = (slot + 1) & mask;
                 }
+                if (table[slot] == empty) {
+                    table[slot] = vertexCount++;
+                    _cache.insert(_cache.end(), vertex.begin(), vertex.end());
+                }
+                _indices.push_back(table[slot]);
             }
-            _isDirty = false;
+            _cache.shrink_to_fit();
+
+            _weldStatistics = {corners, vertexCount};
+            clean(Assembly::Welded);
             return _cache;
         }
 
         /**
-         * @brief 获取通过索引组装的缓冲区的索引[毫无作用][划掉]
+         * @brief 获取最近一次焊接的统计
+         * @details 布局未经WeldIndices组装(例如来自缓存)时两项均为0
+         * @return 焊接统计引用
+         */
+        const WeldStatistics& weldStatistics() const {
+            return _weldStatistics;
+        }
+
+        /**
+         * @brief 获取组装后缓冲区的索引
          * @details 他似乎不需要详细注释[划掉]
          * @return 索引数组引用
          */
@@ -477,6 +1013,122 @@ class VertexLayout {
             return _indices;
         }
 
+        /**
+         * @brief 替换已组装的缓冲区与索引
+         * @details 供网格优化等后处理阶段写回重排后的结果, 替换后布局视为已组装
+         * @param buffer 按元素交错的缓冲区
+         * @param indices 缓冲区索引
+         */
+        void assembled(std::vector<T>&& buffer, std::vector<unsigned int>&& indices) {
+            _cache = std::move(buffer);
+            _indices = std::move(indices);
+            _lods.clear();
+            _meshlets.clear();
+            clean(Assembly::Welded);
+        }
+
+        /**
+         * @brief 获取细节层级表
+         * @details 未生成细节层级时为空, 此时整个索引缓冲区即为唯一层级
+         * @return 细节层级表引用
+         */
+        const std::vector<LodLevel>& lods() const {
+            return _lods;
+        }
+
+        /**
+         * @brief 配置细节层级表
+         * @details 各层级的索引范围需位于当前组装索引内
+         * @param lods 细节层级表
+         */
+        void lods(std::vector<LodLevel>&& lods) {
+            _lods = std::move(lods);
+        }
+
+        /**
+         * @brief 获取簇表
+         * @details 未划分簇时为空
+         * @return 簇表引用
+         */
+        const std::vector<Meshlet>& meshlets() const {
+            return _meshlets;
+        }
+
+        /**
+         * @brief 配置簇表
+         * @details 各簇的索引范围需位于当前组装索引内
+         * @param meshlets 簇表
+         */
+        void meshlets(std::vector<Meshlet>&& meshlets) {
+            _meshlets = std::move(meshlets);
+        }
+
+        /**
+         * @brief 获取布局元素数组
+         * @details 按location顺序排列
+         * @return 布局元素数组引用
+         */
+        const std::vector<LayoutElement>& elements() const {
+            return _layout;
+        }
+
+        /**
+         * @brief 获取包围盒
+         * @details 未附加包围盒时为空包围盒
+         * @return 包围盒引用
+         */
+        const Bounds& bounds() const {
+            return _bounds;
+        }
+
+        /**
+         * @brief 配置包围盒
+         * @details 他似乎不需要详细注释[划掉]
+         * @param bounds 包围盒
+         */
+        void bounds(const Bounds& bounds) {
+            _bounds = bounds;
+        }
+
+        /**
+         * @brief 获取包围球
+         * @details 未附加包围球时为空包围球
+         * @return 包围球引用
+         */
+        const BoundingSphere& sphere() const {
+            return _sphere;
+        }
+
+        /**
+         * @brief 配置包围球
+         * @details 他似乎不需要详细注释[划掉]
+         * @param sphere 包围球
+         */
+        void sphere(const BoundingSphere& sphere) {
+            _sphere = sphere;
+        }
+
+        /**
+         * @brief 由顶点坐标计算包围盒与包围球
+         * @details 优先使用vertices元素的数据源, 数据源为空(例如来自缓存)时使用组装缓冲区; 不含vertices元素时不做任何事
+         */
+        void computeBounds() {
+            if (!contain("vertices")) return;
+            const LayoutElement& e = (*this)["vertices"];
+            if (e.length < 3) return;
+            const T* positions = e._source.data();
+            size_t count = e._source.size() / e.length;
+            size_t stride = e.length;
+            if (count == 0) {
+                const std::vector<T>& buffer = assembled();
+                stride = e.step / sizeof(T);
+                positions = buffer.data() + e.origin / sizeof(T);
+                count = buffer.size() / stride;
+            }
+            _bounds = Bounds::fromPositions(positions, count, stride);
+            _sphere = BoundingSphere::fromPositions(positions, count, stride, _bounds.center());
+        }
+
         /**
          * @brief 缓冲区组装布局是否包含元素
          * @details 他似乎不需要详细注释[划掉]
@@ -508,13 +1160,193 @@ class VertexLayout {
 
 
     private:
+        /**
+         * @brief 组装方式
+         * @details Sequential为assemblyBuffer按顶点一一对应组装, Expanded为ExpandIndices按面角展开, Welded为WeldIndices焊接;
+         *          由构建者或assembled直接提供的已组装缓冲区视为焊接结果
+         */
+        enum class Assembly {
+            Sequential,
+            Expanded,
+            Welded
+        };
+
         std::vector<LayoutElement> _layout;
         std::map<std::string, size_t> _identifierMap;
         std::vector<T> _cache;
         std::vector<unsigned int> _indices;
         std::vector<unsigned int> _rawIndices;
+        Bounds _bounds{};
+        BoundingSphere _sphere{};
+        WeldStatistics _weldStatistics{};
+        std::vector<LodLevel> _lods;
+        std::vector<Meshlet> _meshlets;
+        std::vector<VertexRange> _uploadRanges;
+        StreamMode _streamMode{StreamMode::Interleaved};
+        Assembly _assembly{Assembly::Welded};
         bool _isDirty{true};
 
+        /**
+         * @brief 校验存储格式与元素长度是否匹配
+         * @details 他似乎不需要详细注释[划掉]
+         * @param identifier 元素标识符
+         * @param length 元素长度
+         * @param format 存储格式
+         */
+        static void checkFormat(const std::string& identifier, size_t length, StorageFormat format) {
+            if (format == StorageFormat::Octahedral && length != 3) {
+                throw std::runtime_error("八面体编码仅支持3分量元素: " + identifier);
+            }
+        }
+
+        /**
+         * @brief 计算打包后各元素的偏移与跨度
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        void packedLayout() {
+            size_t offset{0};
+            for (auto& e : _layout) {
+                e.packedOrigin = offset;
+                offset += VertexFormat::packedSize(e.format, e.length);
+            }
+            for (auto& e : _layout) {
+                e.packedStep = offset;
+            }
+        }
+
+        /**
+         * @brief 处理数据源的局部更新
+         * @details 由assemblyBuffer组装且布局不为脏时, 只将各元素脏区间内的顶点重新交错进组装缓冲区并计入上传区间;
+         *          否则将布局标记为脏, 由之后的组装整体重建
+         */
+        void applyDirtyRanges() {
+            if (std::all_of(_layout.begin(), _layout.end(), [](const LayoutElement& e) { return e.dirtyRange.isEmpty(); })) {
+                return;
+            }
+            if (_isDirty || _assembly != Assembly::Sequential) {
+                _isDirty = true;
+                return;
+            }
+            const size_t stride = _layout[0].step / sizeof(T);
+            const size_t vertexCount = _cache.size() / stride;
+            for (auto& e : _layout) {
+                const size_t first = e.dirtyRange.first;
+                const size_t count = first < vertexCount ? (std::min)(e.dirtyRange.count, vertexCount - first) : 0;
+                e.dirtyRange = {};
+                if (count == 0) continue;
+                VertexInterleave::Stream stream{e._source.data() + first * e.length, e.length * sizeof(T), e.origin};
+                VertexInterleave::interleave(_cache.data() + first * stride, e.step, &stream, 1, count);
+                markUpload(e, first, count);
+            }
+        }
+
+        /**
+         * @brief 记录元素等待上传的顶点区间
+         * @details Interleaved模式下记入布局的上传区间, Separate模式下记入该元素的上传区间
+         * @param e 被修改的元素
+         * @param first 起始顶点
+         * @param count 顶点数量
+         */
+        void markUpload(LayoutElement& e, size_t first, size_t count) {
+            markUpload(_streamMode == StreamMode::Separate ? e._uploadRanges : _uploadRanges, first, count);
+        }
+
+        /**
+         * @brief 记录等待上传的顶点区间
+         * @details 与已有区间相交或相邻时合并, 区间数超过maxUploadRanges时全部合并为一个
+         * @param ranges 上传区间
+         * @param first 起始顶点
+         * @param count 顶点数量
+         */
+        static void markUpload(std::vector<VertexRange>& ranges, size_t first, size_t count) {
+            if (count == 0) return;
+            VertexRange range{first, count};
+            for (bool isMerged = true; isMerged;) {
+                isMerged = false;
+                for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+                    if (it->first <= range.first + range.count && range.first <= it->first + it->count) {
+                        range.merge(it->first, it->count);
+                        ranges.erase(it);
+                        isMerged = true;
+                        break;
+                    }
+                }
+            }
+            ranges.push_back(range);
+            if (ranges.size() > maxUploadRanges) {
+                for (const VertexRange& r : ranges) {
+                    range.merge(r.first, r.count);
+                }
+                ranges.assign(1, range);
+            }
+        }
+
+        /**
+         * @brief 整体组装完成
+         * @details 清除脏标记, 各元素的脏区间与上传区间, 并记录组装方式
+         * @param assembly 组装方式
+         */
+        void clean(Assembly assembly) {
+            for (auto& e : _layout) {
+                e.dirtyRange = {};
+            }
+            clearUploadRanges();
+            _assembly = assembly;
+            _isDirty = false;
+        }
+
+        /**
+         * @brief 清空布局与各元素的上传区间
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        void clearUploadRanges() {
+            _uploadRanges.clear();
+            for (auto& e : _layout) {
+                e._uploadRanges.clear();
+            }
+        }
+
+        /**
+         * @brief 写入等待上传的顶点区间
+         * @details 逐个区间以glMapBufferRange映射后由pack直接打包写入, 映射失败时退回glBufferSubData, 完成后清空区间
+         * @tparam Pack 打包函数类型, 签名为void(size_t first, size_t count, void* out)
+         * @param target 缓冲区绑定目标
+         * @param ranges 上传区间
+         * @param unit 单个顶点在缓冲区中的字节数
+         * @param base 起始字节偏移
+         * @param pack 打包函数
+         */
+        template<typename Pack>
+        static void subData(GLenum target, std::vector<VertexRange>& ranges, size_t unit, GLintptr base, const Pack& pack) {
+            std::vector<unsigned char> data;
+            for (const VertexRange& range : ranges) {
+                const auto offset = base + static_cast<GLintptr>(range.first * unit);
+                const auto size = static_cast<GLsizeiptr>(range.count * unit);
+                if (void* mapped = glMapBufferRange(target, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT)) {
+                    pack(range.first, range.count, mapped);
+                    if (glUnmapBuffer(target) == GL_TRUE) continue;
+                }
+                data.resize(static_cast<size_t>(size));
+                pack(range.first, range.count, data.data());
+                glBufferSubData(target, offset, size, data.data());
+            }
+            ranges.clear();
+        }
+
+        /**
+         * @brief 以各元素数据源构造交错数据流
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 按location顺序排列的数据流
+         */
+        std::vector<VertexInterleave::Stream> interleaveStreams() const {
+            std::vector<VertexInterleave::Stream> streams;
+            streams.reserve(_layout.size());
+            for (const auto& e : _layout) {
+                streams.push_back({e._source.data(), e.length * sizeof(T), e.origin});
+            }
+            return streams;
+        }
+
         /**
          * @brief 构建者使用的缓冲区组装布局构造
          * @details 他似乎不需要详细注释[划掉]
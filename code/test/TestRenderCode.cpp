@@ -12,6 +12,7 @@
 #include <EventTypes.hpp>
 #include <ModelParser.h>
 #include <Bezier.h>
+#include <GLState.h>
 #include <GlobalLogger.hpp>
 
 using namespace std;
@@ -44,19 +45,12 @@ void TestRenderCode::init() {
     glfwSetScrollCallback(window, scroll_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
 
-    map<string, VertexLayout<float>> modelVertices = ModelParser::ObjModelLoader(resource::utils::readFileToStr(modelPath));
+    // 解析与准备在工作线程上进行, 渲染线程每帧在预算内上传已完成的对象
+    loader.load(modelPath, [](const string&, VertexLayout<float>& layout) {
+        Model::prepare(layout);
+    });
 
-    for (auto& e : modelVertices) {
-        models.emplace(piecewise_construct,
-            forward_as_tuple(e.first),
-            forward_as_tuple(e.first, rootNode.addChild(e.first), std::move(e.second), ebus)
-        );
-    }
-    for (auto& model : models) {
-        model.second.init();
-    }
-
-    glEnable(GL_DEPTH_TEST);
+    GLState::shared().enable(GL_DEPTH_TEST);
     camera._position = {0.0f, -0.0f, 1.0f};
     proj = glm::perspective(glm::radians(90.0f), 800.0f / 600.0f, 0.1f, 100.0f);
 
@@ -65,6 +59,7 @@ void TestRenderCode::init() {
 
 void TestRenderCode::render(double delta) {
     _delta = delta;
+    modelUpload();
     camera._delta = delta;
 
     glViewport(0, 0, frameWidth, frameHeight);
@@ -77,9 +72,41 @@ void TestRenderCode::render(double delta) {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 
+    // 位于共享几何存储的模型经排序后合并提交, 其余模型逐个绘制
+    GLState& state = GLState::shared();
+    state.bindTexture(0, GL_TEXTURE_2D, texture);
     for (auto& model : models) {
-        glBindTexture(GL_TEXTURE_2D, texture);
-        model.second.render(delta, proj, cameraMatrix);
+        if (!model.second.record(batch, proj, cameraMatrix, texture)) {
+            model.second.render(delta, proj, cameraMatrix);
+        }
+    }
+    batch.submit(GeometryStore::shared());
+
+    // 每秒输出一次上一帧的状态调用统计
+    state.frame();
+    _stateLogSeconds += delta;
+    if (_stateLogSeconds >= 1.0) {
+        _stateLogSeconds = 0.0;
+        const auto& statistics = state.statistics();
+        glog.log<DefaultLevel::Debug>("状态调用: 发出" + to_string(statistics.issued) + "次, 丢弃" + to_string(statistics.elided)
+            + "次; 绘制调用" + to_string(batch.calls()) + "次");
+    }
+}
+
+void TestRenderCode::modelUpload() {
+    try {
+        loader.drain([this](string name, VertexLayout<float> layout) {
+            auto [it, isInsert] = models.emplace(piecewise_construct,
+                forward_as_tuple(name),
+                forward_as_tuple(name, rootNode.addChild(name), std::move(layout), ebus)
+            );
+            if (!isInsert) return;
+            it->second.viewportHeight(frameHeight);
+            it->second.init();
+        });
+    } catch (const exception& e) {
+        // 载入失败的模型不显示, 其余模型照常渲染
+        glog.log<DefaultLevel::Error>(string("模型载入失败: ") + e.what());
     }
 }
 
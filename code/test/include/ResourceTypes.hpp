@@ -5,7 +5,9 @@
 
 #include <stb_image.h>
 
+#include <GLState.h>
 #include <GlobalLogger.hpp>
+#include <MappedFile.hpp>
 #include <RAIIWrapper.hpp>
 #include <Resource.hpp>
 
@@ -14,25 +16,32 @@ namespace resource::utils {
     namespace fs = std::filesystem;
 
     /**
-     * @brief 读取文件并转换为字符串
-     * @details 他似乎不需要详细注释[划掉]
+     * @brief 以只读方式映射文件
+     * @details 解析器可直接在映射内存上原地解析, 大文件按需分页载入而不必整体拷贝
      * @param path 文件路径
-     * @return 字符串
+     * @return 文件映射, 失败时为空映射
      */
-    inline string readFileToStr(const fs::path& path) {
+    inline MappedFile mapFile(const fs::path& path) {
         if (!fs::exists(path)) {
             glog.log<DefaultLevel::Error>("文件不存在: " + path.string());
             return {};
         }
 
-        ifstream file(path);
-        if (!file.is_open()) {
+        MappedFile file(path);
+        if (!file.isOpen()) {
             glog.log<DefaultLevel::Error>("文件无法打开: " + path.string());
-            return {};
         }
-        string out{istreambuf_iterator<char>(file), istreambuf_iterator<char>()};
-        file.close();
-        return out;
+        return file;
+    }
+
+    /**
+     * @brief 读取文件并转换为字符串
+     * @details 基于文件映射, 仅产生一次拷贝
+     * @param path 文件路径
+     * @return 字符串
+     */
+    inline string readFileToStr(const fs::path& path) {
+        return string(mapFile(path).view());
     }
 }
 
@@ -56,8 +65,7 @@ class Texture: public RAIIWrapper<GLuint>, IResource {
                 std::terminate();
             }
             glGenTextures(1, &_value);
-            glBindTexture(GL_TEXTURE_2D, _value);
-            glActiveTexture(GL_TEXTURE0);
+            GLState::shared().bindTexture(0, GL_TEXTURE_2D, _value);
 
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -67,7 +75,7 @@ class Texture: public RAIIWrapper<GLuint>, IResource {
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, imgWidth, imgHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
             glGenerateMipmap(GL_TEXTURE_2D);
 
-            glBindTexture(GL_TEXTURE_2D, 0);
+            GLState::shared().bindTexture(0, GL_TEXTURE_2D, 0);
 
             _value = 1;
             stbi_image_free(data);
@@ -79,7 +87,7 @@ class Texture: public RAIIWrapper<GLuint>, IResource {
          */
         ~Texture() override {
             glog.log<DefaultLevel::Debug>("纹理对象已析构: " + std::to_string(_value));
-            glDeleteTextures(1, &_value);
+            GLState::shared().deleteTextures(1, &_value);
         }
     private:
         int imgWidth{}, imgHeight{};
@@ -97,7 +105,7 @@ class VertexArrays: public RAIIWrapper<GLuint> {
         }
         ~VertexArrays() override {
             glog.log<DefaultLevel::Debug>("顶点数组对象已析构: " + std::to_string(_value));
-            glDeleteVertexArrays(1, &_value);
+            GLState::shared().deleteVertexArrays(1, &_value);
         }
 };
 
@@ -112,7 +120,7 @@ class BufferObject: public RAIIWrapper<GLuint> {
         }
 
         ~BufferObject() override {
-            glDeleteBuffers(1, &_value);
+            GLState::shared().deleteBuffers(1, &_value);
         }
 };
 
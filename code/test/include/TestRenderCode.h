@@ -9,6 +9,8 @@
 #include <Transform.h>
 #include <Node.hpp>
 #include <VertexLayout.hpp>
+#include <AsyncModelLoader.h>
+#include <DrawBatch.h>
 #include <Model.h>
 #include <EventBus.hpp>
 
@@ -46,4 +48,13 @@ class TestRenderCode {
         Node<Transform> rootNode;
         glm::mat4 proj{1.0f};
         Camera camera{};
+        AsyncModelLoader loader{};
+        DrawBatch batch{};
+        double _stateLogSeconds{};
+
+        /**
+         * @brief 上传异步载入完成的模型
+         * @details 每帧在AsyncModelLoader的时间预算内执行
+         */
+        void modelUpload();
 };
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace hashing {
+    inline constexpr uint64_t fnv1aOffset = 14695981039346656037ull;
+    inline constexpr uint64_t fnv1aPrime = 1099511628211ull;
+
+    /**
+     * @brief FNV-1a 64位哈希
+     * @details 非加密哈希, 用于内容校验与缓存键
+     * @param data 数据
+     * @param size 数据长度
+     * @param seed 初始值, 可传入上一段的结果以进行链式哈希
+     * @return 哈希值
+     */
+    inline uint64_t fnv1a(const void* data, size_t size, uint64_t seed = fnv1aOffset) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        uint64_t out = seed;
+        for (size_t i = 0; i < size; i++) {
+            out ^= bytes[i];
+            out *= fnv1aPrime;
+        }
+        return out;
+    }
+
+    /**
+     * @brief FNV-1a 64位哈希[字符串]
+     * @details 他似乎不需要详细注释[划掉]
+     * @param str 字符串
+     * @param seed 初始值
+     * @return 哈希值
+     */
+    inline uint64_t fnv1a(std::string_view str, uint64_t seed = fnv1aOffset) {
+        return fnv1a(str.data(), str.size(), seed);
+    }
+
+    /**
+     * @brief 组合两个哈希值
+     * @details 他似乎不需要详细注释[划掉]
+     * @param seed 原哈希值
+     * @param value 新哈希值
+     * @return 组合后的哈希值
+     */
+    inline uint64_t combine(uint64_t seed, uint64_t value) {
+        return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+    }
+}
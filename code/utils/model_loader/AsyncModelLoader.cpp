@@ -0,0 +1,85 @@
+#include "AsyncModelLoader.h"
+
+#include <map>
+#include <optional>
+
+#include <ModelParser.h>
+#include <ThreadPool.hpp>
+#include <GlobalLogger.hpp>
+
+using namespace std;
+
+AsyncModelLoader::~AsyncModelLoader() {
+    for (auto& task : _tasks) {
+        task.wait();
+    }
+}
+
+void AsyncModelLoader::load(const std::filesystem::path &path, Prepare prepare) {
+    _loading++;
+    _tasks.emplace_back(ThreadPool::shared().submit([this, path, prepare = std::move(prepare)] {
+        auto begin = chrono::steady_clock::now();
+        try {
+            map<string, VertexLayout<float>> models = path.extension() == ".glb"
+                ? ModelParser::GlbModelLoader(path)
+                : ModelParser::ObjModelCacheLoader(path);
+
+            vector<map<string, VertexLayout<float>>::iterator> objects{};
+            objects.reserve(models.size());
+            for (auto it = models.begin(); it != models.end(); ++it) {
+                objects.push_back(it);
+            }
+            ThreadPool::shared().parallelFor(objects.size(), [this, &objects, &prepare](size_t i) {
+                auto& [name, layout] = *objects[i];
+                if (prepare) prepare(name, layout);
+                push(name, std::move(layout));
+            });
+
+            chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - begin;
+            glog.log<DefaultLevel::Debug>("异步载入完成: " + path.string() + ", 耗时: " + to_string(elapsed.count()) + "ms");
+        } catch (...) {
+            // 先入队再减少计数, 使isIdle在异常被取出之前不会报告完成
+            glog.log<DefaultLevel::Error>("异步载入失败: " + path.string());
+            lock_guard lock(_mtx);
+            _failures.push_back(current_exception());
+        }
+        _loading--;
+    }));
+}
+
+size_t AsyncModelLoader::drain(const Upload &upload, std::chrono::microseconds budget) {
+    auto begin = chrono::steady_clock::now();
+    size_t count{};
+    do {
+        optional<Item> item{};
+        {
+            lock_guard lock(_mtx);
+            if (!_failures.empty()) {
+                exception_ptr failure = std::move(_failures.front());
+                _failures.pop_front();
+                rethrow_exception(failure);
+            }
+            if (_ready.empty()) break;
+            item.emplace(std::move(_ready.front()));
+            _ready.pop_front();
+        }
+        upload(std::move(item->name), std::move(item->layout));
+        count++;
+    } while (chrono::steady_clock::now() - begin < budget);
+    return count;
+}
+
+size_t AsyncModelLoader::pending() {
+    lock_guard lock(_mtx);
+    return _ready.size();
+}
+
+bool AsyncModelLoader::isIdle() {
+    lock_guard lock(_mtx);
+    return _loading.load() == 0 && _ready.empty() && _failures.empty();
+}
+
+void AsyncModelLoader::push(std::string name, VertexLayout<float> layout) {
+    lock_guard lock(_mtx);
+    _ready.push_back({std::move(name), std::move(layout)});
+}
@@ -0,0 +1,382 @@
+#include "ModelParser.h"
+
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+#include "GlobalLogger.hpp"
+#include "Json.h"
+#include "MappedFile.hpp"
+#include "VertexGenerator.h"
+
+using namespace std;
+
+namespace {
+    constexpr uint32_t glbMagic = 0x46546C67;  // "glTF"
+    constexpr uint32_t glbChunkJson = 0x4E4F534A;  // "JSON"
+    constexpr uint32_t glbChunkBin = 0x004E4942;  // "BIN\0"
+
+    constexpr int componentByte = 5120;
+    constexpr int componentUnsignedByte = 5121;
+    constexpr int componentShort = 5122;
+    constexpr int componentUnsignedShort = 5123;
+    constexpr int componentUnsignedInt = 5125;
+    constexpr int componentFloat = 5126;
+
+    constexpr size_t modeTriangles = 4;
+
+    uint32_t readU32(const char* data) {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    [[noreturn]] void glbError(const string& message) {
+        glog.log<DefaultLevel::Error>("错误: glb模型" + message);
+        std::terminate();
+    }
+
+    /**
+     * @brief 读取下标, 长度等非负整数字段
+     * @details 字段缺失时为默认值; 存在但不是非负整数时报错终止, 以免在越界检查之前就被截断为看似有效的值
+     * @param value 字段
+     * @param name 字段名, 用于报错
+     * @param fallback 缺失时的默认值
+     * @return 整数
+     */
+    size_t glbIndex(const Json& value, const string& name, size_t fallback = 0) {
+        if (value.isNull()) return fallback;
+        if (!value.isIndex()) glbError("字段不是有效的非负整数: " + name);
+        return value.index();
+    }
+
+    size_t componentSize(int componentType) {
+        switch (componentType) {
+            case componentByte:
+            case componentUnsignedByte: return 1;
+            case componentShort:
+            case componentUnsignedShort: return 2;
+            case componentUnsignedInt:
+            case componentFloat: return 4;
+            default: return 0;
+        }
+    }
+
+    size_t componentCount(const string& type) {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        return 0;
+    }
+
+    /**
+     * @brief 访问器在缓冲区中的视图
+     * @details data指向首个元素, 已校验全部元素都位于缓冲视图内
+     */
+    struct AccessorView {
+        const unsigned char* data{};
+        size_t count{};
+        size_t components{};
+        size_t stride{};
+        int componentType{};
+        bool normalized{};
+
+        [[nodiscard]] const unsigned char* element(size_t i) const {
+            return data + i * stride;
+        }
+
+        /**
+         * @brief 读取一个分量并转为float
+         * @details 归一化整数按glTF规范换算, 有符号类型截断到-1
+         */
+        [[nodiscard]] float read(size_t i, size_t component) const {
+            const unsigned char* p = element(i) + component * componentSize(componentType);
+            switch (componentType) {
+                case componentFloat: {
+                    float value;
+                    memcpy(&value, p, sizeof(value));
+                    return value;
+                }
+                case componentByte: {
+                    auto value = static_cast<float>(static_cast<int8_t>(*p));
+                    return normalized ? (std::max)(value / 127.0f, -1.0f) : value;
+                }
+                case componentUnsignedByte: {
+                    auto value = static_cast<float>(*p);
+                    return normalized ? value / 255.0f : value;
+                }
+                case componentShort: {
+                    int16_t raw;
+                    memcpy(&raw, p, sizeof(raw));
+                    auto value = static_cast<float>(raw);
+                    return normalized ? (std::max)(value / 32767.0f, -1.0f) : value;
+                }
+                case componentUnsignedShort: {
+                    uint16_t raw;
+                    memcpy(&raw, p, sizeof(raw));
+                    auto value = static_cast<float>(raw);
+                    return normalized ? value / 65535.0f : value;
+                }
+                case componentUnsignedInt: {
+                    uint32_t raw;
+                    memcpy(&raw, p, sizeof(raw));
+                    return static_cast<float>(raw);
+                }
+                default: return 0.0f;
+            }
+        }
+
+        /**
+         * @brief 读取一个索引
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        [[nodiscard]] unsigned int index(size_t i) const {
+            const unsigned char* p = element(i);
+            switch (componentType) {
+                case componentUnsignedByte: return *p;
+                case componentUnsignedShort: {
+                    uint16_t raw;
+                    memcpy(&raw, p, sizeof(raw));
+                    return raw;
+                }
+                default: {
+                    uint32_t raw;
+                    memcpy(&raw, p, sizeof(raw));
+                    return raw;
+                }
+            }
+        }
+
+        /**
+         * @brief 对应的顶点存储格式
+         * @details 归一化的short/ushort直接沿用其位宽, 其余类型展开为float
+         */
+        [[nodiscard]] StorageFormat format() const {
+            if (normalized && componentType == componentShort) return StorageFormat::Snorm16;
+            if (normalized && componentType == componentUnsignedShort) return StorageFormat::Unorm16;
+            return StorageFormat::Float;
+        }
+    };
+
+    /**
+     * @brief glTF文档与其缓冲区
+     * @details 外部缓冲区按uri相对glb所在目录映射, 生命周期与文档一致
+     */
+    class GlbDocument {
+        public:
+            GlbDocument(const Json& root, string_view bin, const filesystem::path& directory): _root(root) {
+                const Json& buffers = root["buffers"];
+                _files.reserve(buffers.size());
+                for (size_t i = 0; i < buffers.size(); i++) {
+                    const Json& buffer = buffers[i];
+                    size_t byteLength = glbIndex(buffer["byteLength"], "byteLength");
+                    string_view data{};
+                    if (!buffer.contains("uri")) {
+                        if (i != 0) glbError("缓冲区缺少uri: " + to_string(i));
+                        data = bin;
+                    } else {
+                        const string& uri = buffer["uri"].string();
+                        if (uri.rfind("data:", 0) == 0) glbError("不支持内嵌data uri缓冲区: " + to_string(i));
+                        _files.emplace_back(directory / filesystem::u8path(uri));
+                        if (!_files.back().isOpen()) glbError("外部缓冲区无法打开: " + uri);
+                        data = _files.back().view();
+                    }
+                    if (data.size() < byteLength) glbError("缓冲区长度不足: " + to_string(i));
+                    _buffers.push_back(data.substr(0, byteLength));
+                }
+            }
+
+            /**
+             * @brief 获取访问器视图
+             * @details 越界, 未知类型与稀疏访问器直接报错终止
+             */
+            [[nodiscard]] AccessorView accessor(size_t index) const {
+                const Json& accessor = _root["accessors"][index];
+                if (accessor.isNull()) glbError("访问器不存在: " + to_string(index));
+                if (accessor.contains("sparse")) glbError("不支持稀疏访问器: " + to_string(index));
+
+                AccessorView view{};
+                view.count = glbIndex(accessor["count"], "count");
+                view.components = componentCount(accessor["type"].string());
+                view.componentType = static_cast<int>(glbIndex(accessor["componentType"], "componentType"));
+                view.normalized = accessor["normalized"].boolean();
+                size_t elementSize = view.components * componentSize(view.componentType);
+                if (elementSize == 0) glbError("访问器类型未知: " + to_string(index));
+
+                const Json& bufferView = _root["bufferViews"][glbIndex(accessor["bufferView"], "bufferView", ~size_t{0})];
+                if (bufferView.isNull()) glbError("访问器缺少缓冲视图: " + to_string(index));
+                size_t bufferIndex = glbIndex(bufferView["buffer"], "buffer");
+                if (bufferIndex >= _buffers.size()) glbError("缓冲视图引用的缓冲区不存在: " + to_string(bufferIndex));
+                string_view buffer = _buffers[bufferIndex];
+
+                size_t viewOffset = glbIndex(bufferView["byteOffset"], "byteOffset");
+                size_t viewLength = glbIndex(bufferView["byteLength"], "byteLength");
+                size_t offset = glbIndex(accessor["byteOffset"], "byteOffset");
+                view.stride = glbIndex(bufferView["byteStride"], "byteStride", elementSize);
+                if (viewOffset > buffer.size() || viewLength > buffer.size() - viewOffset) glbError("缓冲视图越界: " + to_string(index));
+                if (view.stride < elementSize) glbError("访问器跨度无效: " + to_string(index));
+                if (view.count != 0) {
+                    if (offset > viewLength || elementSize > viewLength - offset
+                        || view.count - 1 > (viewLength - offset - elementSize) / view.stride) {
+                        glbError("访问器越界: " + to_string(index));
+                    }
+                }
+                view.data = reinterpret_cast<const unsigned char*>(buffer.data()) + viewOffset + offset;
+                return view;
+            }
+
+        private:
+            const Json& _root;
+            vector<MappedFile> _files;
+            vector<string_view> _buffers;
+    };
+
+    /**
+     * @brief 顶点属性通道
+     * @details 与obj导入使用相同的元素标识符, 保证location一致
+     */
+    struct Channel {
+        const char* semantic;
+        const char* identifier;
+        size_t length;
+    };
+
+    constexpr Channel channels[] = {
+        {"POSITION", "vertices", 3},
+        {"TEXCOORD_0", "texCoord", 2},
+        {"NORMAL", "normal", 3},
+    };
+
+    /**
+     * @brief 将图元转为缓冲区组装布局
+     * @details 全为float且与布局同序交错时整块拷贝, 否则逐分量读取; 纹理坐标翻转v轴以匹配obj的左下原点约定
+     */
+    optional<VertexLayout<float>> primitiveBuild(const GlbDocument& document, const Json& primitive) {
+        const Json& attributes = primitive["attributes"];
+        if (!attributes.contains("POSITION")) return nullopt;
+
+        vector<pair<const Channel*, AccessorView>> views{};
+        auto builder = VertexLayout<float>::builder();
+        size_t stride{};
+        for (const Channel& channel : channels) {
+            if (!attributes.contains(channel.semantic)) continue;
+            AccessorView view = document.accessor(glbIndex(attributes[channel.semantic], channel.semantic));
+            if (view.components != channel.length) glbError(string("属性分量数量不符: ") + channel.semantic);
+            if (!views.empty() && view.count != views[0].second.count) glbError(string("属性数量不一致: ") + channel.semantic);
+            builder.appendElement(channel.identifier, channel.length, view.format());
+            views.emplace_back(&channel, view);
+            stride += channel.length;
+        }
+        const size_t vertexCount = views[0].second.count;
+
+        vector<float> buffer(vertexCount * stride);
+        bool isInterleaved = true;
+        size_t offset{};
+        for (const auto& [channel, view] : views) {
+            isInterleaved = isInterleaved && view.componentType == componentFloat && view.stride == stride * sizeof(float)
+                && view.data == views[0].second.data + offset * sizeof(float);
+            offset += channel->length;
+        }
+        if (isInterleaved) {
+            memcpy(buffer.data(), views[0].second.data, buffer.size() * sizeof(float));
+        } else {
+            offset = 0;
+            for (const auto& [channel, view] : views) {
+                for (size_t v = 0; v < vertexCount; v++) {
+                    for (size_t c = 0; c < channel->length; c++) {
+                        buffer[v * stride + offset + c] = view.read(v, c);
+                    }
+                }
+                offset += channel->length;
+            }
+        }
+        offset = 0;
+        for (const auto& [channel, view] : views) {
+            if (string_view(channel->identifier) == "texCoord") {
+                for (size_t v = 0; v < vertexCount; v++) {
+                    float& t = buffer[v * stride + offset + 1];
+                    t = 1.0f - t;
+                }
+            }
+            offset += channel->length;
+        }
+
+        vector<unsigned int> indices{};
+        if (primitive.contains("indices")) {
+            AccessorView view = document.accessor(glbIndex(primitive["indices"], "indices"));
+            if (view.components != 1 || view.componentType == componentFloat || view.componentType == componentShort || view.componentType == componentByte) {
+                glbError("索引访问器类型无效");
+            }
+            indices.resize(view.count);
+            for (size_t i = 0; i < view.count; i++) {
+                indices[i] = view.index(i);
+                if (indices[i] >= vertexCount) glbError("索引越界: " + to_string(indices[i]));
+            }
+        } else {
+            indices.resize(vertexCount);
+            iota(indices.begin(), indices.end(), 0u);
+        }
+        indices.resize(indices.size() - indices.size() % 3);
+
+        VertexLayout<float> layout = builder.attachAssembled(std::move(buffer), std::move(indices)).build();
+        layout.computeBounds();
+        return layout;
+    }
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::GlbModelLoader(const std::filesystem::path &path) {
+    MappedFile source(path);
+    if (!source.isOpen()) {
+        glog.log<DefaultLevel::Error>("错误: glb模型无法打开: " + path.string());
+        std::terminate();
+    }
+    auto models = GlbModelLoader::parser(source.view(), path.parent_path());
+    VertexGenerator::generate(models);
+    return models;
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::GlbModelLoader::parser(std::string_view source, const std::filesystem::path &directory) {
+    if (source.size() < 12 || readU32(source.data()) != glbMagic) glbError("文件头无效");
+    if (readU32(source.data() + 4) != 2) glbError("仅支持glTF 2.0");
+    source = source.substr(0, (std::min<size_t>)(readU32(source.data() + 8), source.size()));
+
+    string_view json{}, bin{};
+    for (size_t offset = 12; offset + 8 <= source.size();) {
+        size_t length = readU32(source.data() + offset);
+        uint32_t type = readU32(source.data() + offset + 4);
+        offset += 8;
+        if (length > source.size() - offset) glbError("数据块越界");
+        if (type == glbChunkJson && json.empty()) json = source.substr(offset, length);
+        else if (type == glbChunkBin && bin.empty()) bin = source.substr(offset, length);
+        offset += (length + 3) & ~static_cast<size_t>(3);
+    }
+
+    optional<Json> root = Json::parse(json);
+    if (!root) glbError("JSON数据块无效");
+    GlbDocument document(*root, bin, directory);
+
+    map<string, VertexLayout<float>> models{};
+    const Json& meshes = (*root)["meshes"];
+    for (size_t m = 0; m < meshes.size(); m++) {
+        const Json& mesh = meshes[m];
+        const Json& primitives = mesh["primitives"];
+        string name = mesh["name"].string().empty() ? "mesh" + to_string(m) : mesh["name"].string();
+        for (size_t p = 0; p < primitives.size(); p++) {
+            const Json& primitive = primitives[p];
+            if (glbIndex(primitive["mode"], "mode", modeTriangles) != modeTriangles) {
+                glog.log<DefaultLevel::Warn>("跳过非三角形图元: " + name);
+                continue;
+            }
+            optional<VertexLayout<float>> layout = primitiveBuild(document, primitive);
+            if (!layout) {
+                glog.log<DefaultLevel::Warn>("跳过缺少POSITION的图元: " + name);
+                continue;
+            }
+            string key = primitives.size() > 1 ? name + "." + to_string(p) : name;
+            if (models.count(key) != 0) key += "#" + to_string(m);
+            models.emplace(std::move(key), std::move(*layout));
+        }
+    }
+    return models;
+}
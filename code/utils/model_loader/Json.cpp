@@ -0,0 +1,241 @@
+#include "Json.h"
+
+#include <charconv>
+#include <cstdint>
+
+using namespace std;
+
+namespace {
+    const Json nullJson{};
+    const string emptyString{};
+
+    constexpr size_t maxDepth = 256;
+}
+
+/**
+ * @brief 递归下降解析器
+ * @details 出错时返回false并停止, 嵌套深度受maxDepth限制以免恶意输入耗尽栈
+ */
+class Json::Parser {
+    public:
+        explicit Parser(std::string_view source): _it(source.data()), _end(source.data() + source.size()) {}
+
+        bool document(Json& out) {
+            if (!value(out, 0)) return false;
+            whitespace();
+            return _it == _end;
+        }
+
+    private:
+        const char* _it;
+        const char* _end;
+
+        void whitespace() {
+            while (_it != _end && (*_it == ' ' || *_it == '\t' || *_it == '\n' || *_it == '\r')) _it++;
+        }
+
+        bool literal(std::string_view word) {
+            if (static_cast<size_t>(_end - _it) < word.size() || string_view(_it, word.size()) != word) return false;
+            _it += word.size();
+            return true;
+        }
+
+        bool value(Json& out, size_t depth) {
+            if (depth > maxDepth) return false;
+            whitespace();
+            if (_it == _end) return false;
+            switch (*_it) {
+                case '{': return object(out, depth);
+                case '[': return array(out, depth);
+                case '"': {
+                    out._type = String;
+                    return text(out._string);
+                }
+                case 't': {
+                    out._type = Bool;
+                    out._boolean = true;
+                    return literal("true");
+                }
+                case 'f': {
+                    out._type = Bool;
+                    out._boolean = false;
+                    return literal("false");
+                }
+                case 'n': {
+                    out._type = Null;
+                    return literal("null");
+                }
+                default: {
+                    out._type = Number;
+                    return number(out._number);
+                }
+            }
+        }
+
+        bool object(Json& out, size_t depth) {
+            out._type = Object;
+            _it++;
+            whitespace();
+            if (_it != _end && *_it == '}') {
+                _it++;
+                return true;
+            }
+            while (true) {
+                whitespace();
+                std::string key;
+                if (_it == _end || *_it != '"' || !text(key)) return false;
+                whitespace();
+                if (_it == _end || *_it != ':') return false;
+                _it++;
+                out._members.emplace_back(std::move(key), Json{});
+                if (!value(out._members.back().second, depth + 1)) return false;
+                whitespace();
+                if (_it == _end) return false;
+                if (*_it == '}') {
+                    _it++;
+                    return true;
+                }
+                if (*_it != ',') return false;
+                _it++;
+            }
+        }
+
+        bool array(Json& out, size_t depth) {
+            out._type = Array;
+            _it++;
+            whitespace();
+            if (_it != _end && *_it == ']') {
+                _it++;
+                return true;
+            }
+            while (true) {
+                out._elements.emplace_back();
+                if (!value(out._elements.back(), depth + 1)) return false;
+                whitespace();
+                if (_it == _end) return false;
+                if (*_it == ']') {
+                    _it++;
+                    return true;
+                }
+                if (*_it != ',') return false;
+                _it++;
+            }
+        }
+
+        bool number(double& out) {
+            // from_chars还接受inf与nan, 因此先确认以负号或数字开头
+            if (*_it != '-' && (*_it < '0' || *_it > '9')) return false;
+            auto [ptr, ec] = from_chars(_it, _end, out);
+            if (ec != errc() || ptr == _it) return false;
+            _it = ptr;
+            return true;
+        }
+
+        bool hex4(uint32_t& out) {
+            if (_end - _it < 4) return false;
+            out = 0;
+            for (int i = 0; i < 4; i++, _it++) {
+                char c = *_it;
+                out <<= 4;
+                if (c >= '0' && c <= '9') out |= static_cast<uint32_t>(c - '0');
+                else if (c >= 'a' && c <= 'f') out |= static_cast<uint32_t>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F') out |= static_cast<uint32_t>(c - 'A' + 10);
+                else return false;
+            }
+            return true;
+        }
+
+        static void utf8(std::string& out, uint32_t code) {
+            if (code < 0x80) {
+                out.push_back(static_cast<char>(code));
+            } else if (code < 0x800) {
+                out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else if (code < 0x10000) {
+                out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            } else {
+                out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        }
+
+        bool text(std::string& out) {
+            _it++;
+            while (_it != _end) {
+                char c = *_it++;
+                if (c == '"') return true;
+                if (static_cast<unsigned char>(c) < 0x20) return false;
+                if (c != '\\') {
+                    out.push_back(c);
+                    continue;
+                }
+                if (_it == _end) return false;
+                switch (*_it++) {
+                    case '"': out.push_back('"'); break;
+                    case '\\': out.push_back('\\'); break;
+                    case '/': out.push_back('/'); break;
+                    case 'b': out.push_back('\b'); break;
+                    case 'f': out.push_back('\f'); break;
+                    case 'n': out.push_back('\n'); break;
+                    case 'r': out.push_back('\r'); break;
+                    case 't': out.push_back('\t'); break;
+                    case 'u': {
+                        uint32_t code;
+                        if (!hex4(code)) return false;
+                        if (code >= 0xD800 && code < 0xDC00) {
+                            uint32_t low;
+                            if (_end - _it < 2 || _it[0] != '\\' || _it[1] != 'u') return false;
+                            _it += 2;
+                            if (!hex4(low) || low < 0xDC00 || low >= 0xE000) return false;
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        } else if (code >= 0xDC00 && code < 0xE000) {
+                            return false;
+                        }
+                        utf8(out, code);
+                        break;
+                    }
+                    default: return false;
+                }
+            }
+            return false;
+        }
+};
+
+std::optional<Json> Json::parse(std::string_view source) {
+    Json root{};
+    Parser parser(source);
+    if (!parser.document(root)) return nullopt;
+    return root;
+}
+
+size_t Json::size() const {
+    if (_type == Array) return _elements.size();
+    if (_type == Object) return _members.size();
+    return 0;
+}
+
+bool Json::contains(std::string_view key) const {
+    for (const auto& [name, value] : _members) {
+        if (name == key) return true;
+    }
+    return false;
+}
+
+const Json& Json::operator[](std::string_view key) const {
+    for (const auto& [name, value] : _members) {
+        if (name == key) return value;
+    }
+    return nullJson;
+}
+
+const Json& Json::operator[](size_t index) const {
+    return index < _elements.size() ? _elements[index] : nullJson;
+}
+
+const std::string& Json::string() const {
+    return _type == String ? _string : emptyString;
+}
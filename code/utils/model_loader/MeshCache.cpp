@@ -0,0 +1,392 @@
+#include "MeshCache.h"
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+
+#include "Hash.hpp"
+#include "MappedFile.hpp"
+#include "MeshCodec.h"
+
+using namespace std;
+namespace fs = filesystem;
+
+namespace {
+    /**
+     * @brief 缓存文件头
+     * @details 所有成员自然对齐, 文件中紧随其后的是objectCount个对象记录
+     */
+    struct CacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceMtime;
+        uint64_t sourceHash;
+        uint32_t objectCount;
+        uint32_t flags;
+    };
+
+    /**
+     * @brief 布局元素记录
+     * @details 与VertexLayout::LayoutElement对应, 标识符以长度前缀字符串写在记录之前
+     */
+    struct ElementRecord {
+        uint32_t length;
+        uint32_t location;
+        uint32_t origin;
+        uint32_t step;
+    };
+
+    /**
+     * @brief 细节层级记录
+     * @details 与VertexLayout::LodLevel对应
+     */
+    struct LodRecord {
+        uint64_t indexOffset;
+        uint64_t indexCount;
+        float error;
+        uint32_t reserved;
+    };
+
+    /**
+     * @brief 簇记录
+     * @details 与VertexLayout::Meshlet对应
+     */
+    struct MeshletRecord {
+        uint64_t indexOffset;
+        uint64_t indexCount;
+        glm::vec3 center;
+        float radius;
+        glm::vec3 coneAxis;
+        float coneCutoff;
+    };
+
+    class CacheWriter {
+        public:
+            explicit CacheWriter(ofstream& out): _out(out) {}
+
+            template<typename T>
+            void pod(const T& value) {
+                bytes(&value, sizeof(T));
+            }
+
+            void bytes(const void* data, size_t size) {
+                _out.write(static_cast<const char*>(data), static_cast<streamsize>(size));
+                _offset += size;
+            }
+
+            void str(string_view value) {
+                pod(static_cast<uint32_t>(value.size()));
+                bytes(value.data(), value.size());
+            }
+
+            /**
+             * @brief 以0填充到4字节对齐
+             * @details 使映射后的浮点与索引数组可以直接按对齐地址访问
+             */
+            void align() {
+                static constexpr char zero[4]{};
+                bytes(zero, (4 - _offset % 4) % 4);
+            }
+        private:
+            ofstream& _out;
+            size_t _offset{0};
+    };
+
+    class CacheReader {
+        public:
+            CacheReader(const char* begin, const char* end): _begin(begin), _it(begin), _end(end) {}
+
+            template<typename T>
+            bool pod(T& value) {
+                if (!check(sizeof(T))) return false;
+                memcpy(&value, _it, sizeof(T));
+                _it += sizeof(T);
+                return true;
+            }
+
+            bool str(string& value) {
+                uint32_t size{};
+                if (!pod(size) || !check(size)) return false;
+                value.assign(_it, size);
+                _it += size;
+                return true;
+            }
+
+            bool align() {
+                size_t padding = (4 - static_cast<size_t>(_it - _begin) % 4) % 4;
+                if (!check(padding)) return false;
+                _it += padding;
+                return true;
+            }
+
+            /**
+             * @brief 读取一段字节
+             * @details 返回的指针指向映射内存, 不进行拷贝
+             */
+            bool bytes(const unsigned char*& value, uint64_t size) {
+                if (size > static_cast<uint64_t>(_end - _it)) return _isOk = false;
+                value = reinterpret_cast<const unsigned char*>(_it);
+                _it += size;
+                return true;
+            }
+
+            template<typename T>
+            bool array(vector<T>& value, uint64_t count) {
+                if (count > static_cast<uint64_t>(_end - _it) / sizeof(T)) return _isOk = false;
+                value.resize(count);
+                memcpy(value.data(), _it, count * sizeof(T));
+                _it += count * sizeof(T);
+                return true;
+            }
+
+        private:
+            const char* _begin;
+            const char* _it;
+            const char* _end;
+            bool _isOk{true};
+
+            bool check(size_t size) {
+                if (static_cast<size_t>(_end - _it) < size) {
+                    _isOk = false;
+                }
+                return _isOk;
+            }
+    };
+
+    int64_t mtimeOf(const fs::path& path) {
+        error_code ec;
+        auto time = fs::last_write_time(path, ec);
+        if (ec) return 0;
+        return static_cast<int64_t>(time.time_since_epoch().count());
+    }
+
+    /**
+     * @brief 校验缓存是否仍对应源文件
+     * @details 源文件不存在时缓存视为有效, 以便只分发缓存的情况
+     * @param mtime 源文件当前的修改时间; 与记录不同但内容哈希一致时, 调用方应以restamp更新记录
+     */
+    bool isFresh(const CacheHeader& header, const fs::path& source, int64_t& mtime) {
+        mtime = header.sourceMtime;
+        error_code ec;
+        uint64_t size = fs::file_size(source, ec);
+        if (ec) return true;
+        if (size != header.sourceSize) return false;
+        mtime = mtimeOf(source);
+        if (mtime == header.sourceMtime) return true;
+        MappedFile content(source);
+        return content.isOpen() && hashing::fnv1a(content.view()) == header.sourceHash;
+    }
+
+    /**
+     * @brief 原地更新缓存记录的源文件修改时间
+     * @details 源文件只被touch而内容未变时调用, 使之后的启动重新走修改时间的快速路径而不必再次哈希整个源文件
+     */
+    void restamp(const fs::path& path, int64_t mtime) {
+        fstream file(path, ios::binary | ios::in | ios::out);
+        if (!file.is_open()) return;
+        file.seekp(static_cast<streamoff>(offsetof(CacheHeader, sourceMtime)));
+        file.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+    }
+}
+
+std::filesystem::path MeshCache::cachePath(const std::filesystem::path &source) {
+    fs::path out = source;
+    out += ".meshcache";
+    return out;
+}
+
+MeshCache::SourceStamp MeshCache::stamp(const std::filesystem::path &source, std::string_view content) {
+    return {content.size(), mtimeOf(source), hashing::fnv1a(content)};
+}
+
+bool MeshCache::write(const std::filesystem::path &path, const SourceStamp &stamp, std::map<std::string, VertexLayout<float>> &models, bool isCompressed) {
+    fs::path temp = path;
+    temp += ".tmp";
+    error_code ec;
+    {
+        ofstream out(temp, ios::binary | ios::trunc);
+        if (!out.is_open()) return false;
+        CacheWriter writer(out);
+
+        writer.pod(CacheHeader{magic, version, stamp.size, stamp.mtime, stamp.hash, static_cast<uint32_t>(models.size()), isCompressed ? flagCompressed : 0});
+        for (auto& [name, layout] : models) {
+            const vector<float>& vertices = layout.WeldIndices();
+            const vector<unsigned int>& indices = layout.bufferOfIndices();
+            if (vertices.empty()) {
+                out.close();
+                fs::remove(temp, ec);
+                return false;
+            }
+
+            if (layout.bounds().isEmpty() || layout.sphere().isEmpty()) {
+                layout.computeBounds();
+            }
+            const Bounds& bounds = layout.bounds();
+            const BoundingSphere& sphere = layout.sphere();
+
+            writer.str(name);
+            writer.pod(static_cast<uint32_t>(layout.elements().size()));
+            for (const auto& e : layout.elements()) {
+                writer.str(e.identifier);
+                writer.pod(ElementRecord{
+                    static_cast<uint32_t>(e.length),
+                    static_cast<uint32_t>(e.location),
+                    static_cast<uint32_t>(e.origin),
+                    static_cast<uint32_t>(e.step)
+                });
+            }
+            writer.pod(bounds.minimum());
+            writer.pod(bounds.maximum());
+            writer.pod(sphere.center());
+            writer.pod(sphere.radius());
+            writer.pod(static_cast<uint64_t>(vertices.size()));
+            writer.pod(static_cast<uint64_t>(indices.size()));
+            if (isCompressed) {
+                const size_t vertexSize = layout.elements()[0].step;
+                vector<unsigned char> encodedVertices = MeshCodec::encodeVertices(vertices.data(), vertices.size() * sizeof(float) / vertexSize, vertexSize);
+                vector<unsigned char> encodedIndices = MeshCodec::encodeIndices(indices.data(), indices.size());
+                writer.pod(static_cast<uint64_t>(encodedVertices.size()));
+                writer.pod(static_cast<uint64_t>(encodedIndices.size()));
+                writer.bytes(encodedVertices.data(), encodedVertices.size());
+                writer.bytes(encodedIndices.data(), encodedIndices.size());
+                writer.align();
+            } else {
+                writer.align();
+                writer.bytes(vertices.data(), vertices.size() * sizeof(float));
+                writer.bytes(indices.data(), indices.size() * sizeof(unsigned int));
+            }
+            writer.pod(static_cast<uint32_t>(layout.lods().size()));
+            for (const auto& lod : layout.lods()) {
+                writer.pod(LodRecord{lod.indexOffset, lod.indexCount, lod.error, 0});
+            }
+            writer.pod(static_cast<uint32_t>(layout.meshlets().size()));
+            for (const auto& meshlet : layout.meshlets()) {
+                writer.pod(MeshletRecord{meshlet.indexOffset, meshlet.indexCount, meshlet.center, meshlet.radius, meshlet.coneAxis, meshlet.coneCutoff});
+            }
+        }
+        if (!out) {
+            out.close();
+            fs::remove(temp, ec);
+            return false;
+        }
+    }
+
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::map<std::string, VertexLayout<float>>> MeshCache::read(const std::filesystem::path &path, const std::filesystem::path &source) {
+    error_code ec;
+    if (!fs::exists(path, ec)) return nullopt;
+    MappedFile file(path);
+    if (!file.isOpen()) return nullopt;
+
+    CacheReader reader(file.data(), file.data() + file.size());
+    CacheHeader header{};
+    if (!reader.pod(header) || header.magic != magic || header.version != version) return nullopt;
+    int64_t mtime{};
+    if (!isFresh(header, source, mtime)) return nullopt;
+
+    map<string, VertexLayout<float>> models{};
+    try {
+        for (uint32_t i = 0; i < header.objectCount; i++) {
+            string name;
+            uint32_t elementCount{};
+            if (!reader.str(name) || !reader.pod(elementCount)) return nullopt;
+
+            auto builder = VertexLayout<float>::builder();
+            vector<ElementRecord> records(elementCount);
+            for (auto& record : records) {
+                string identifier;
+                if (!reader.str(identifier) || !reader.pod(record)) return nullopt;
+                builder.appendElement(identifier, record.length);
+            }
+            if (records.empty()) return nullopt;
+
+            glm::vec3 minimum{}, maximum{}, center{};
+            float radius{};
+            uint64_t vertexCount{}, indexCount{};
+            vector<float> vertices;
+            vector<unsigned int> indices;
+            if (!reader.pod(minimum) || !reader.pod(maximum)
+                || !reader.pod(center) || !reader.pod(radius)
+                || !reader.pod(vertexCount) || !reader.pod(indexCount)) {
+                return nullopt;
+            }
+            if ((header.flags & flagCompressed) != 0) {
+                const size_t vertexSize = records[0].step;
+                uint64_t encodedVertexSize{}, encodedIndexSize{};
+                const unsigned char* encodedVertices{};
+                const unsigned char* encodedIndices{};
+                // 损坏的步长可能不足一个浮点, 须先排除再取模, 否则除数为0
+                if (vertexSize == 0 || vertexSize % sizeof(float) != 0 || vertexCount % (vertexSize / sizeof(float)) != 0
+                    || !reader.pod(encodedVertexSize) || !reader.pod(encodedIndexSize)
+                    || !reader.bytes(encodedVertices, encodedVertexSize)
+                    || !reader.bytes(encodedIndices, encodedIndexSize)
+                    || !reader.align()) {
+                    return nullopt;
+                }
+                // 每64个顶点的每个字节平面至少有1字节平面头, 每个索引至少占1字节, 以此在分配前拒绝伪造的巨大数量
+                if (vertexCount > encodedVertexSize * 64 || indexCount > encodedIndexSize) return nullopt;
+                vertices.resize(vertexCount);
+                indices.resize(indexCount);
+                if (!MeshCodec::decodeVertices(vertices.data(), vertexCount * sizeof(float) / vertexSize, vertexSize, encodedVertices, encodedVertexSize)
+                    || !MeshCodec::decodeIndices(indices.data(), indexCount, encodedIndices, encodedIndexSize)) {
+                    return nullopt;
+                }
+            } else if (!reader.align()
+                || !reader.array(vertices, vertexCount)
+                || !reader.array(indices, indexCount)) {
+                return nullopt;
+            }
+
+            uint32_t lodCount{};
+            if (!reader.pod(lodCount)) return nullopt;
+            vector<VertexLayout<float>::LodLevel> lods(lodCount);
+            for (auto& lod : lods) {
+                LodRecord record{};
+                if (!reader.pod(record) || record.indexOffset + record.indexCount > indexCount) return nullopt;
+                lod = {static_cast<size_t>(record.indexOffset), static_cast<size_t>(record.indexCount), record.error};
+            }
+
+            uint32_t meshletCount{};
+            if (!reader.pod(meshletCount)) return nullopt;
+            vector<VertexLayout<float>::Meshlet> meshlets(meshletCount);
+            for (auto& meshlet : meshlets) {
+                MeshletRecord record{};
+                if (!reader.pod(record) || record.indexOffset + record.indexCount > indexCount) return nullopt;
+                meshlet = {static_cast<size_t>(record.indexOffset), static_cast<size_t>(record.indexCount), record.center, record.radius, record.coneAxis, record.coneCutoff};
+            }
+
+            VertexLayout<float> layout = builder
+                .attachAssembled(std::move(vertices), std::move(indices))
+                .attachBounds(Bounds(minimum, maximum), BoundingSphere(center, radius))
+                .build();
+
+            for (size_t e = 0; e < records.size(); e++) {
+                const auto& element = layout.elements()[e];
+                if (element.location != records[e].location || element.origin != records[e].origin || element.step != records[e].step) {
+                    return nullopt;
+                }
+            }
+            layout.lods(std::move(lods));
+            layout.meshlets(std::move(meshlets));
+            models.emplace(std::move(name), std::move(layout));
+        }
+    } catch (const std::runtime_error&) {
+        return nullopt;
+    }
+    if (mtime != header.sourceMtime) {
+        file.close();
+        restamp(path, mtime);
+    }
+    return models;
+}
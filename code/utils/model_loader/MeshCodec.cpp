@@ -0,0 +1,284 @@
+#include "MeshCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEARN_CODEC_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    constexpr size_t groupBytes[4] = {0, 4, 8, 16};
+
+    uint32_t zigzag32(uint32_t delta) {
+        auto value = static_cast<int32_t>(delta);
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    uint32_t unzigzag32(uint32_t value) {
+        return (value >> 1) ^ (0u - (value & 1u));
+    }
+
+    /**
+     * @brief 选择一组的位宽编号
+     * @details 0~3分别对应0, 2, 4, 8位
+     */
+    unsigned groupWidth(const unsigned char* group) {
+        unsigned char maximum = 0;
+        for (size_t i = 0; i < MeshCodec::groupSize; i++) {
+            maximum = (std::max)(maximum, group[i]);
+        }
+        if (maximum == 0) return 0;
+        if (maximum < 4) return 1;
+        if (maximum < 16) return 2;
+        return 3;
+    }
+
+    void groupPack(const unsigned char* group, unsigned width, vector<unsigned char>& out) {
+        switch (width) {
+            case 1: {
+                for (size_t i = 0; i < MeshCodec::groupSize; i += 4) {
+                    out.push_back(static_cast<unsigned char>(group[i] | group[i + 1] << 2 | group[i + 2] << 4 | group[i + 3] << 6));
+                }
+                break;
+            }
+            case 2: {
+                for (size_t i = 0; i < MeshCodec::groupSize; i += 2) {
+                    out.push_back(static_cast<unsigned char>(group[i] | group[i + 1] << 4));
+                }
+                break;
+            }
+            case 3: {
+                out.insert(out.end(), group, group + MeshCodec::groupSize);
+                break;
+            }
+            default: ;
+        }
+    }
+
+    /**
+     * @brief 解包一组
+     * @details SSE2下2位与4位组各只需数次移位, 掩码与交织
+     */
+    void groupUnpack(const unsigned char* data, unsigned width, unsigned char* group) {
+        switch (width) {
+            case 0: {
+                memset(group, 0, MeshCodec::groupSize);
+                break;
+            }
+            case 1: {
+#ifdef LEARN_CODEC_SSE2
+                uint32_t packed;
+                memcpy(&packed, data, sizeof(packed));
+                const __m128i mask = _mm_set1_epi8(3);
+                __m128i x = _mm_cvtsi32_si128(static_cast<int>(packed));
+                __m128i a = _mm_and_si128(x, mask);
+                __m128i b = _mm_and_si128(_mm_srli_epi16(x, 2), mask);
+                __m128i c = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+                __m128i d = _mm_and_si128(_mm_srli_epi16(x, 6), mask);
+                __m128i result = _mm_unpacklo_epi16(_mm_unpacklo_epi8(a, b), _mm_unpacklo_epi8(c, d));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(group), result);
+#else
+                for (size_t i = 0; i < MeshCodec::groupSize; i++) {
+                    group[i] = static_cast<unsigned char>(data[i >> 2] >> ((i & 3) * 2) & 3);
+                }
+#endif
+                break;
+            }
+            case 2: {
+#ifdef LEARN_CODEC_SSE2
+                const __m128i mask = _mm_set1_epi8(15);
+                __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+                __m128i low = _mm_and_si128(x, mask);
+                __m128i high = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(group), _mm_unpacklo_epi8(low, high));
+#else
+                for (size_t i = 0; i < MeshCodec::groupSize; i++) {
+                    group[i] = static_cast<unsigned char>(data[i >> 1] >> ((i & 1) * 4) & 15);
+                }
+#endif
+                break;
+            }
+            default: {
+                memcpy(group, data, MeshCodec::groupSize);
+            }
+        }
+    }
+
+    /**
+     * @brief 由4个字节平面还原一列字并写出
+     * @details 字节平面合并为zigzag差值, 还原符号后做前缀和; SSE2下每次处理4个字, 前缀和以两次移位相加完成
+     * @param planes 4个字节平面, 各含groups * groupSize字节
+     * @param count 本块顶点数量
+     * @param last 上一块最后一个字, 会被更新
+     * @param out 本块首个顶点中该字的地址
+     * @param stride 顶点字节数
+     */
+    void wordDecode(const unsigned char (&planes)[4][MeshCodec::maxBlockVertices], size_t count, uint32_t& last, unsigned char* out, size_t stride) {
+        size_t i = 0;
+#ifdef LEARN_CODEC_SSE2
+        __m128i carry = _mm_set1_epi32(static_cast<int>(last));
+        const __m128i one = _mm_set1_epi32(1);
+        for (; i + MeshCodec::groupSize <= count; i += MeshCodec::groupSize) {
+            __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[0] + i));
+            __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[1] + i));
+            __m128i p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[2] + i));
+            __m128i p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planes[3] + i));
+            __m128i low01 = _mm_unpacklo_epi8(p0, p1), high01 = _mm_unpackhi_epi8(p0, p1);
+            __m128i low23 = _mm_unpacklo_epi8(p2, p3), high23 = _mm_unpackhi_epi8(p2, p3);
+            __m128i words[4] = {
+                _mm_unpacklo_epi16(low01, low23),
+                _mm_unpackhi_epi16(low01, low23),
+                _mm_unpacklo_epi16(high01, high23),
+                _mm_unpackhi_epi16(high01, high23)
+            };
+            for (size_t q = 0; q < 4; q++) {
+                __m128i z = words[q];
+                __m128i delta = _mm_xor_si128(_mm_srli_epi32(z, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(z, one)));
+                delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 4));
+                delta = _mm_add_epi32(delta, _mm_slli_si128(delta, 8));
+                __m128i value = _mm_add_epi32(delta, carry);
+                carry = _mm_shuffle_epi32(value, _MM_SHUFFLE(3, 3, 3, 3));
+
+                unsigned char* target = out + (i + q * 4) * stride;
+                uint32_t lane = static_cast<uint32_t>(_mm_cvtsi128_si32(value));
+                memcpy(target, &lane, sizeof(lane));
+                lane = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_shuffle_epi32(value, _MM_SHUFFLE(1, 1, 1, 1))));
+                memcpy(target + stride, &lane, sizeof(lane));
+                lane = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_shuffle_epi32(value, _MM_SHUFFLE(2, 2, 2, 2))));
+                memcpy(target + 2 * stride, &lane, sizeof(lane));
+                lane = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+                memcpy(target + 3 * stride, &lane, sizeof(lane));
+            }
+        }
+        last = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+#endif
+        for (; i < count; i++) {
+            uint32_t z = planes[0][i] | static_cast<uint32_t>(planes[1][i]) << 8 | static_cast<uint32_t>(planes[2][i]) << 16 | static_cast<uint32_t>(planes[3][i]) << 24;
+            last += unzigzag32(z);
+            memcpy(out + i * stride, &last, sizeof(last));
+        }
+    }
+}
+
+size_t MeshCodec::blockVertices(size_t vertexSize) {
+    size_t count = 8192 / (std::max)(vertexSize, static_cast<size_t>(1));
+    count = (std::min)(count & ~(groupSize - 1), maxBlockVertices);
+    return (std::max)(count, groupSize);
+}
+
+std::vector<unsigned char> MeshCodec::encodeVertices(const void* vertices, size_t vertexCount, size_t vertexSize) {
+    const auto* source = static_cast<const unsigned char*>(vertices);
+    const size_t blockSize = blockVertices(vertexSize);
+    const size_t wordCount = vertexSize / sizeof(uint32_t);
+    if (vertexSize % sizeof(uint32_t) != 0) return {};
+
+    vector<unsigned char> out{};
+    out.reserve(1 + vertexCount * vertexSize / 2);
+    out.push_back(vertexTag);
+
+    vector<uint32_t> last(wordCount, 0);
+    uint32_t deltas[maxBlockVertices];
+    unsigned char column[maxBlockVertices]{};
+    for (size_t base = 0; base < vertexCount; base += blockSize) {
+        const size_t count = (std::min)(blockSize, vertexCount - base);
+        const size_t groups = (count + groupSize - 1) / groupSize;
+        for (size_t w = 0; w < wordCount; w++) {
+            uint32_t previous = last[w];
+            for (size_t i = 0; i < count; i++) {
+                uint32_t value;
+                memcpy(&value, source + (base + i) * vertexSize + w * sizeof(uint32_t), sizeof(value));
+                deltas[i] = zigzag32(value - previous);
+                previous = value;
+            }
+            last[w] = previous;
+
+            for (size_t b = 0; b < sizeof(uint32_t); b++) {
+                for (size_t i = 0; i < count; i++) {
+                    column[i] = static_cast<unsigned char>(deltas[i] >> (b * 8));
+                }
+                memset(column + count, 0, groups * groupSize - count);
+
+                size_t header = out.size();
+                out.resize(header + (groups + 3) / 4, 0);
+                for (size_t g = 0; g < groups; g++) {
+                    unsigned width = groupWidth(column + g * groupSize);
+                    out[header + g / 4] |= static_cast<unsigned char>(width << ((g % 4) * 2));
+                    groupPack(column + g * groupSize, width, out);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+bool MeshCodec::decodeVertices(void* out, size_t vertexCount, size_t vertexSize, const unsigned char* data, size_t size) {
+    auto* target = static_cast<unsigned char*>(out);
+    const unsigned char* it = data;
+    const unsigned char* end = data + size;
+    if (size == 0 || *it++ != vertexTag || vertexSize % sizeof(uint32_t) != 0) return false;
+    const size_t blockSize = blockVertices(vertexSize);
+    const size_t wordCount = vertexSize / sizeof(uint32_t);
+
+    vector<uint32_t> last(wordCount, 0);
+    unsigned char planes[4][maxBlockVertices];
+    for (size_t base = 0; base < vertexCount; base += blockSize) {
+        const size_t count = (std::min)(blockSize, vertexCount - base);
+        const size_t groups = (count + groupSize - 1) / groupSize;
+        const size_t headerSize = (groups + 3) / 4;
+        for (size_t w = 0; w < wordCount; w++) {
+            for (auto& plane : planes) {
+                const unsigned char* header = it;
+                if (static_cast<size_t>(end - it) < headerSize) return false;
+                it += headerSize;
+                for (size_t g = 0; g < groups; g++) {
+                    unsigned width = header[g / 4] >> ((g % 4) * 2) & 3;
+                    if (static_cast<size_t>(end - it) < groupBytes[width]) return false;
+                    groupUnpack(it, width, plane + g * groupSize);
+                    it += groupBytes[width];
+                }
+            }
+            wordDecode(planes, count, last[w], target + base * vertexSize + w * sizeof(uint32_t), vertexSize);
+        }
+    }
+    return it == end;
+}
+
+std::vector<unsigned char> MeshCodec::encodeIndices(const unsigned int* indices, size_t count) {
+    vector<unsigned char> out{};
+    out.reserve(1 + count + count / 4);
+    out.push_back(indexTag);
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t value = zigzag32(indices[i] - previous);
+        previous = indices[i];
+        while (value >= 0x80) {
+            out.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<unsigned char>(value));
+    }
+    return out;
+}
+
+bool MeshCodec::decodeIndices(unsigned int* out, size_t count, const unsigned char* data, size_t size) {
+    const unsigned char* it = data;
+    const unsigned char* end = data + size;
+    if (size == 0 || *it++ != indexTag) return false;
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t value = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            if (it == end || shift > 28) return false;
+            unsigned char byte = *it++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) break;
+        }
+        previous += unzigzag32(value);
+        out[i] = previous;
+    }
+    return it == end;
+}
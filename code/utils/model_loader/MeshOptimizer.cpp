@@ -0,0 +1,553 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+namespace {
+    constexpr unsigned int invalid = ~0u;
+
+    /**
+     * @brief 顶点到三角形的邻接表
+     * @details offsets[v]到offsets[v + 1]为顶点v所在三角形在triangles中的范围
+     */
+    struct Adjacency {
+        vector<unsigned int> offsets;
+        vector<unsigned int> triangles;
+
+        Adjacency(const vector<unsigned int>& indices, size_t vertexCount):
+            offsets(vertexCount + 1, 0),
+            triangles(indices.size()) {
+            for (unsigned int index : indices) {
+                offsets[index + 1]++;
+            }
+            for (size_t v = 0; v < vertexCount; v++) {
+                offsets[v + 1] += offsets[v];
+            }
+            vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); i++) {
+                triangles[cursor[indices[i]]++] = static_cast<unsigned int>(i / 3);
+            }
+        }
+    };
+
+    /**
+     * @brief 二次误差矩阵
+     * @details 对称4x4矩阵的上三角10项, weight为累计的面积权重, 用于将误差归一化为距离平方
+     */
+    struct Quadric {
+        std::array<double, 10> q{};
+        double weight{};
+
+        void addPlane(double a, double b, double c, double d, double w) {
+            const double plane[4]{a, b, c, d};
+            size_t k = 0;
+            for (size_t i = 0; i < 4; i++) {
+                for (size_t j = i; j < 4; j++) {
+                    q[k++] += plane[i] * plane[j] * w;
+                }
+            }
+            weight += w;
+        }
+
+        Quadric& operator += (const Quadric& other) {
+            for (size_t i = 0; i < q.size(); i++) {
+                q[i] += other.q[i];
+            }
+            weight += other.weight;
+            return *this;
+        }
+
+        /**
+         * @brief 计算点到各平面距离平方的加权和
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        [[nodiscard]] double evaluate(const float* p) const {
+            const double x = p[0], y = p[1], z = p[2];
+            double out = q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+                       + q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+                       + q[7] * z * z + 2 * q[8] * z
+                       + q[9];
+            return (std::max)(out, 0.0);
+        }
+    };
+
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        double cost;
+    };
+
+    void cross(const float* a, const float* b, const float* c, double out[3]) {
+        const double u[3]{double(b[0]) - a[0], double(b[1]) - a[1], double(b[2]) - a[2]};
+        const double v[3]{double(c[0]) - a[0], double(c[1]) - a[1], double(c[2]) - a[2]};
+        out[0] = u[1] * v[2] - u[2] * v[1];
+        out[1] = u[2] * v[0] - u[0] * v[2];
+        out[2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    uint64_t edgeKey(unsigned int a, unsigned int b) {
+        if (a > b) std::swap(a, b);
+        return (static_cast<uint64_t>(a) << 32) | b;
+    }
+
+    /**
+     * @brief 计算不可移动的顶点
+     * @details 只被一个三角形使用的边的端点(网格边界), 以及与其他顶点位置相同的顶点(属性接缝)
+     */
+    vector<bool> lockedVertices(const vector<unsigned int>& indices, const float* positions, size_t vertexCount, size_t stride) {
+        vector<bool> locked(vertexCount, false);
+
+        unordered_map<uint64_t, unsigned int> edges{};
+        edges.reserve(indices.size());
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            for (size_t k = 0; k < 3; k++) {
+                edges[edgeKey(indices[i + k], indices[i + (k + 1) % 3])]++;
+            }
+        }
+        for (const auto& [key, count] : edges) {
+            if (count != 1) continue;
+            locked[key >> 32] = true;
+            locked[key & 0xFFFFFFFFu] = true;
+        }
+
+        vector<unsigned int> order(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) order[v] = static_cast<unsigned int>(v);
+        auto position = [positions, stride](unsigned int v) {
+            const float* p = positions + v * stride;
+            return std::array<float, 3>{p[0], p[1], p[2]};
+        };
+        sort(order.begin(), order.end(), [&position](unsigned int a, unsigned int b) {
+            return position(a) < position(b);
+        });
+        for (size_t i = 1; i < order.size(); i++) {
+            if (position(order[i - 1]) == position(order[i])) {
+                locked[order[i - 1]] = true;
+                locked[order[i]] = true;
+            }
+        }
+        return locked;
+    }
+}
+
+void MeshOptimizer::optimize(VertexLayout<float> &layout, size_t cacheSize) {
+    const vector<float>& buffer = layout.WeldIndices();
+    if (buffer.empty() || layout.elements().empty()) return;
+    const size_t stride = layout.elements()[0].step / sizeof(float);
+    const size_t vertexCount = buffer.size() / stride;
+
+    vector<unsigned int> indices = vertexCacheOrder(layout.bufferOfIndices(), vertexCount, cacheSize);
+    vector<unsigned int> remap = vertexFetchOrder(indices, vertexCount);
+
+    size_t used = vertexCount - static_cast<size_t>(count(remap.begin(), remap.end(), invalid));
+    vector<float> reordered(used * stride);
+    for (size_t v = 0; v < vertexCount; v++) {
+        if (remap[v] == invalid) continue;
+        copy_n(buffer.begin() + v * stride, stride, reordered.begin() + remap[v] * stride);
+    }
+    layout.assembled(std::move(reordered), std::move(indices));
+}
+
+void MeshOptimizer::optimize(std::map<std::string, VertexLayout<float>> &models, size_t cacheSize) {
+    vector<VertexLayout<float>*> layouts;
+    layouts.reserve(models.size());
+    for (auto& [name, layout] : models) {
+        layouts.push_back(&layout);
+    }
+    ThreadPool::shared().parallelFor(layouts.size(), [&layouts, cacheSize](size_t i) {
+        optimize(*layouts[i], cacheSize);
+    });
+}
+
+void MeshOptimizer::buildLods(VertexLayout<float> &layout, const std::vector<float> &ratios, size_t cacheSize) {
+    if (!layout.contain("vertices")) return;
+    const vector<float>& buffer = layout.assembled();
+    if (buffer.empty()) return;
+    const size_t stride = layout.elements()[0].step / sizeof(float);
+    const size_t vertexCount = buffer.size() / stride;
+    const float* positions = buffer.data() + layout["vertices"].origin / sizeof(float);
+
+    vector<unsigned int> indices = layout.bufferOfIndices();
+    const size_t baseCount = indices.size();
+    vector<VertexLayout<float>::LodLevel> lods{{0, baseCount, 0.0f}};
+
+    vector<unsigned int> previous = indices;
+    float totalError = 0.0f;
+    for (float ratio : ratios) {
+        auto target = static_cast<size_t>(static_cast<float>(baseCount / 3) * ratio) * 3;
+        if (target >= previous.size()) continue;
+        float error = 0.0f;
+        vector<unsigned int> level = simplify(previous, positions, vertexCount, stride, target, error);
+        if (level.empty() || level.size() * 20 >= previous.size() * 19) break;  // 缩减不足5%, 继续生成只会得到重复层级
+
+        totalError += error;
+        level = vertexCacheOrder(level, vertexCount, cacheSize);
+        lods.push_back({indices.size(), level.size(), totalError});
+        indices.insert(indices.end(), level.begin(), level.end());
+        previous = std::move(level);
+    }
+    if (lods.size() == 1) return;
+
+    vector<float> vertices = buffer;
+    layout.assembled(std::move(vertices), std::move(indices));
+    layout.lods(std::move(lods));
+}
+
+void MeshOptimizer::buildLods(std::map<std::string, VertexLayout<float>> &models, const std::vector<float> &ratios) {
+    vector<VertexLayout<float>*> layouts;
+    layouts.reserve(models.size());
+    for (auto& [name, layout] : models) {
+        layouts.push_back(&layout);
+    }
+    ThreadPool::shared().parallelFor(layouts.size(), [&layouts, &ratios](size_t i) {
+        buildLods(*layouts[i], ratios);
+    });
+}
+
+void MeshOptimizer::buildMeshlets(VertexLayout<float> &layout, size_t maxVertices, size_t maxTriangles) {
+    if (!layout.contain("vertices") || maxVertices < 3 || maxTriangles == 0) return;
+    const vector<float>& buffer = layout.assembled();
+    if (buffer.empty()) return;
+    const size_t stride = layout.elements()[0].step / sizeof(float);
+    const size_t vertexCount = buffer.size() / stride;
+    const float* positions = buffer.data() + layout["vertices"].origin / sizeof(float);
+    auto position = [positions, stride](unsigned int v) {
+        const float* p = positions + v * stride;
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    vector<unsigned int> indices = layout.bufferOfIndices();
+    const size_t baseCount = layout.lods().empty() ? indices.size() : layout.lods()[0].indexCount;
+    const size_t triangleCount = baseCount / 3;
+    // 末尾不完整的三角形不参与划分, 随退化三角形一并丢弃
+    const vector<unsigned int> base(indices.begin(), indices.begin() + static_cast<ptrdiff_t>(triangleCount * 3));
+    Adjacency adjacency(base, vertexCount);
+
+    vector<bool> assigned(triangleCount, false);
+    vector<size_t> stamp(vertexCount, ~size_t{0});
+    vector<unsigned int> vertices;
+    vector<unsigned int> triangles;
+    vector<VertexLayout<float>::Meshlet> meshlets;
+    size_t write = 0;
+
+    auto emit = [&]() {
+        VertexLayout<float>::Meshlet meshlet{};
+        meshlet.indexOffset = write;
+        meshlet.indexCount = triangles.size() * 3;
+
+        Bounds bounds{};
+        for (unsigned int v : vertices) bounds.expand(position(v));
+        meshlet.center = bounds.center();
+        for (unsigned int v : vertices) {
+            meshlet.radius = (std::max)(meshlet.radius, glm::length(position(v) - meshlet.center));
+        }
+
+        vector<glm::vec3> normals;
+        normals.reserve(triangles.size());
+        glm::vec3 axis{0.0f};
+        for (unsigned int t : triangles) {
+            const unsigned int* corner = base.data() + t * 3;
+            glm::vec3 n = glm::cross(position(corner[1]) - position(corner[0]), position(corner[2]) - position(corner[0]));
+            float length = glm::length(n);
+            if (length == 0.0f) continue;
+            normals.push_back(n / length);
+            axis += normals.back();
+            for (size_t k = 0; k < 3; k++) {
+                indices[write++] = corner[k];
+            }
+        }
+        // 退化三角形不写入, 实际写入数量可能少于簇内三角形数
+        meshlet.indexCount = write - meshlet.indexOffset;
+
+        float axisLength = glm::length(axis);
+        if (axisLength > 0.0f) {
+            meshlet.coneAxis = axis / axisLength;
+            float minDot = 1.0f;
+            for (const auto& n : normals) minDot = (std::min)(minDot, glm::dot(n, meshlet.coneAxis));
+            meshlet.coneCutoff = minDot <= 0.0f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+        }
+        if (meshlet.indexCount != 0) meshlets.push_back(meshlet);
+    };
+
+    size_t seed = 0;
+    for (size_t id = 0; ; id++) {
+        while (seed < triangleCount && assigned[seed]) seed++;
+        if (seed == triangleCount) break;
+
+        vertices.clear();
+        triangles.clear();
+        auto newVertices = [&](size_t t) {
+            size_t out = 0;
+            for (size_t k = 0; k < 3; k++) out += stamp[base[t * 3 + k]] != id;
+            return out;
+        };
+
+        size_t current = seed;
+        while (true) {
+            assigned[current] = true;
+            triangles.push_back(static_cast<unsigned int>(current));
+            for (size_t k = 0; k < 3; k++) {
+                unsigned int v = base[current * 3 + k];
+                if (stamp[v] == id) continue;
+                stamp[v] = id;
+                vertices.push_back(v);
+            }
+            if (triangles.size() >= maxTriangles) break;
+
+            size_t best = triangleCount, bestNew = 4;
+            for (size_t i = 0; i < vertices.size() && bestNew != 0; i++) {
+                unsigned int v = vertices[i];
+                for (unsigned int a = adjacency.offsets[v]; a < adjacency.offsets[v + 1]; a++) {
+                    unsigned int t = adjacency.triangles[a];
+                    if (assigned[t]) continue;
+                    size_t added = newVertices(t);
+                    if (vertices.size() + added > maxVertices || added >= bestNew) continue;
+                    best = t;
+                    bestNew = added;
+                    if (bestNew == 0) break;
+                }
+            }
+            if (best == triangleCount) break;
+            current = best;
+        }
+        emit();
+    }
+
+    // 丢弃退化三角形后最细层级变短, 其后各层级的偏移需要同步前移
+    vector<VertexLayout<float>::LodLevel> lods = layout.lods();
+    const size_t removed = baseCount - write;
+    if (removed != 0) {
+        indices.erase(indices.begin() + static_cast<ptrdiff_t>(write), indices.begin() + static_cast<ptrdiff_t>(baseCount));
+        for (auto& lod : lods) {
+            if (lod.indexOffset == 0) lod.indexCount = write;
+            else lod.indexOffset -= removed;
+        }
+    }
+
+    vector<float> copy = buffer;
+    layout.assembled(std::move(copy), std::move(indices));
+    layout.lods(std::move(lods));
+    layout.meshlets(std::move(meshlets));
+}
+
+void MeshOptimizer::buildMeshlets(std::map<std::string, VertexLayout<float>> &models, size_t maxVertices, size_t maxTriangles) {
+    vector<VertexLayout<float>*> layouts;
+    layouts.reserve(models.size());
+    for (auto& [name, layout] : models) {
+        layouts.push_back(&layout);
+    }
+    ThreadPool::shared().parallelFor(layouts.size(), [&layouts, maxVertices, maxTriangles](size_t i) {
+        buildMeshlets(*layouts[i], maxVertices, maxTriangles);
+    });
+}
+
+std::vector<unsigned int> MeshOptimizer::simplify(const std::vector<unsigned int> &indices, const float *positions, size_t vertexCount, size_t stride, size_t targetIndexCount, float &error) {
+    error = 0.0f;
+    vector<unsigned int> out(indices.begin(), indices.end() - static_cast<ptrdiff_t>(indices.size() % 3));
+    if (out.size() <= targetIndexCount || vertexCount == 0) return out;
+
+    auto position = [positions, stride](unsigned int v) {
+        return positions + v * stride;
+    };
+
+    vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i + 2 < out.size(); i += 3) {
+        const float* p0 = position(out[i]);
+        double n[3];
+        cross(p0, position(out[i + 1]), position(out[i + 2]), n);
+        double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+        if (length == 0.0) continue;
+        double a = n[0] / length, b = n[1] / length, c = n[2] / length;
+        double d = -(a * p0[0] + b * p0[1] + c * p0[2]);
+        for (size_t k = 0; k < 3; k++) {
+            quadrics[out[i + k]].addPlane(a, b, c, d, length * 0.5);
+        }
+    }
+    const vector<bool> locked = lockedVertices(out, positions, vertexCount, stride);
+
+    vector<unsigned int> remap(vertexCount);
+    vector<bool> touched(vertexCount);
+    vector<Collapse> collapses;
+    double maxCost = 0.0;
+
+    while (out.size() > targetIndexCount) {
+        collapses.clear();
+        for (size_t i = 0; i < out.size(); i += 3) {
+            for (size_t k = 0; k < 3; k++) {
+                unsigned int a = out[i + k], b = out[i + (k + 1) % 3];
+                for (auto [from, to] : {pair{a, b}, pair{b, a}}) {
+                    if (locked[from]) continue;
+                    Quadric q = quadrics[from];
+                    q += quadrics[to];
+                    double cost = q.weight > 0.0 ? q.evaluate(position(to)) / q.weight : 0.0;
+                    collapses.push_back({from, to, cost});
+                }
+            }
+        }
+        if (collapses.empty()) break;
+        sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) {
+            return l.cost < r.cost;
+        });
+
+        Adjacency adjacency(out, vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) remap[v] = static_cast<unsigned int>(v);
+        fill(touched.begin(), touched.end(), false);
+
+        // 每次坍缩约去除两个三角形; 同一轮内被涉及的顶点不再参与坍缩, 以保证代价与翻转检查仍然有效
+        const size_t needed = (out.size() - targetIndexCount) / 3;
+        size_t removed = 0;
+        for (const Collapse& collapse : collapses) {
+            if (removed >= needed) break;
+            if (touched[collapse.from] || touched[collapse.to]) continue;
+
+            bool isFlipped = false;
+            for (unsigned int i = adjacency.offsets[collapse.from]; i < adjacency.offsets[collapse.from + 1] && !isFlipped; i++) {
+                const unsigned int* triangle = out.data() + adjacency.triangles[i] * 3;
+                unsigned int corners[3]{remap[triangle[0]], remap[triangle[1]], remap[triangle[2]]};
+                if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) continue;
+
+                double before[3], after[3];
+                cross(position(corners[0]), position(corners[1]), position(corners[2]), before);
+                for (unsigned int& corner : corners) {
+                    if (corner == collapse.from) corner = collapse.to;
+                }
+                cross(position(corners[0]), position(corners[1]), position(corners[2]), after);
+                isFlipped = before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0;
+            }
+            if (isFlipped) continue;
+
+            remap[collapse.from] = collapse.to;
+            quadrics[collapse.to] += quadrics[collapse.from];
+            touched[collapse.from] = true;
+            touched[collapse.to] = true;
+            maxCost = (std::max)(maxCost, collapse.cost);
+            removed += 2;
+        }
+        if (removed == 0) break;
+
+        size_t write = 0;
+        for (size_t i = 0; i < out.size(); i += 3) {
+            unsigned int a = remap[out[i]], b = remap[out[i + 1]], c = remap[out[i + 2]];
+            if (a == b || b == c || a == c) continue;
+            out[write++] = a;
+            out[write++] = b;
+            out[write++] = c;
+        }
+        out.resize(write);
+    }
+
+    error = static_cast<float>(std::sqrt(maxCost));
+    return out;
+}
+
+std::vector<unsigned int> MeshOptimizer::vertexCacheOrder(const std::vector<unsigned int> &indices, size_t vertexCount, size_t cacheSize) {
+    if (indices.size() % 3 != 0) {
+        // 末尾不完整的三角形会使邻接表引用不存在的三角形, 丢弃后再重排
+        return vertexCacheOrder(vector<unsigned int>(indices.begin(), indices.end() - static_cast<ptrdiff_t>(indices.size() % 3)), vertexCount, cacheSize);
+    }
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) return indices;
+
+    Adjacency adjacency(indices, vertexCount);
+    vector<unsigned int> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+    vector<size_t> cacheTime(vertexCount, 0);
+    vector<bool> emitted(triangleCount, false);
+    vector<unsigned int> deadEnd;
+    vector<unsigned int> candidates;
+    vector<unsigned int> out;
+    out.reserve(triangleCount * 3);
+
+    size_t time = cacheSize + 1;
+    size_t cursor = 1;
+    unsigned int fanning = 0;
+
+    while (fanning != invalid) {
+        candidates.clear();
+        for (unsigned int i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; i++) {
+            unsigned int triangle = adjacency.triangles[i];
+            if (emitted[triangle]) continue;
+            for (size_t k = 0; k < 3; k++) {
+                unsigned int v = indices[triangle * 3 + k];
+                out.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize) {
+                    cacheTime[v] = time++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // 优先选择仍在缓存中, 且输出其剩余三角形后不会被挤出缓存的顶点中最早进入缓存的
+        unsigned int next = invalid;
+        size_t best = 0;
+        for (unsigned int v : candidates) {
+            if (live[v] == 0) continue;
+            size_t priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize) {
+                priority = time - cacheTime[v];
+            }
+            if (next == invalid || priority > best) {
+                best = priority;
+                next = v;
+            }
+        }
+
+        if (next == invalid) {
+            while (!deadEnd.empty()) {
+                unsigned int v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) {
+                    next = v;
+                    break;
+                }
+            }
+        }
+        while (next == invalid && cursor < vertexCount) {
+            if (live[cursor] > 0) {
+                next = static_cast<unsigned int>(cursor);
+            }
+            cursor++;
+        }
+        fanning = next;
+    }
+    return out;
+}
+
+std::vector<unsigned int> MeshOptimizer::vertexFetchOrder(std::vector<unsigned int> &indices, size_t vertexCount) {
+    vector<unsigned int> remap(vertexCount, invalid);
+    unsigned int next = 0;
+    for (unsigned int& index : indices) {
+        if (remap[index] == invalid) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    return remap;
+}
+
+double MeshOptimizer::acmr(const std::vector<unsigned int> &indices, size_t vertexCount, size_t cacheSize) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) return 0.0;
+
+    vector<size_t> cacheTime(vertexCount, 0);
+    size_t time = cacheSize + 1;
+    size_t misses = 0;
+    for (unsigned int index : indices) {
+        if (time - cacheTime[index] > cacheSize) {
+            cacheTime[index] = time++;
+            misses++;
+        }
+    }
+    return static_cast<double>(misses) / static_cast<double>(triangleCount);
+}
@@ -1,19 +1,424 @@
 #include "ModelParser.h"
+#include <charconv>
+#include <fstream>
+#include <optional>
 #include <sstream>
+#include <utility>
 
 #include "GlobalLogger.hpp"
+#include "MappedFile.hpp"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.hpp"
+#include "VertexGenerator.h"
 
 using namespace std;
 
-std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLoader(const std::string &source) {
+namespace {
+    /**
+     * @brief 从源中切出下一行
+     * @details 切出的行不包含换行符, 同时去除\r以兼容CRLF
+     * @param source 剩余源, 会被推进到下一行
+     * @param line 切出的行
+     * @return 是否成功切出
+     */
+    bool nextLine(string_view& source, string_view& line) {
+        if (source.empty()) return false;
+        size_t end = source.find('\n');
+        if (end == string_view::npos) {
+            line = source;
+            source = {};
+        } else {
+            line = source.substr(0, end);
+            source.remove_prefix(end + 1);
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return true;
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t';
+    }
+
+    void skipSpace(const char*& it, const char* end) {
+        while (it != end && isSpace(*it)) ++it;
+    }
+
+    /**
+     * @brief 判断是否为关键字行
+     * @details 他似乎不需要详细注释[划掉]
+     * @param line 行
+     * @param keyword 关键字
+     * @return 他似乎不需要注释[划掉]
+     */
+    bool isKeyword(string_view line, string_view keyword) {
+        if (line.size() < keyword.size() || line.compare(0, keyword.size(), keyword) != 0) return false;
+        return line.size() == keyword.size() || isSpace(line[keyword.size()]);
+    }
+
+    string_view objectName(string_view line) {
+        line.remove_prefix(1);
+        while (!line.empty() && isSpace(line.front())) line.remove_prefix(1);
+        while (!line.empty() && isSpace(line.back())) line.remove_suffix(1);
+        return line;
+    }
+
+    /**
+     * @brief 解析浮点数
+     * @details 解析失败时不推进游标并输出0
+     * @param it 游标
+     * @param end 行尾
+     * @return 浮点数
+     */
+    float parseFloat(const char*& it, const char* end) {
+        skipSpace(it, end);
+        if (it != end && *it == '+') ++it;
+        float out{0.0f};
+        auto [ptr, ec] = from_chars(it, end, out);
+        if (ec != errc()) return 0.0f;
+        it = ptr;
+        return out;
+    }
+
+    /**
+     * @brief 将obj索引转换为对象内索引
+     * @details obj索引从1开始且全局计数, 负数索引相对于当前已读取的元素
+     * @param index obj索引
+     * @param start 对象全局起点
+     * @param count 对象内已读取数量
+     * @return 对象内索引
+     */
+    unsigned int localIndex(long long index, size_t start, size_t count) {
+        if (index < 0) {
+            return static_cast<unsigned int>(static_cast<long long>(count) + index);
+        }
+        return static_cast<unsigned int>(index - 1 - static_cast<long long>(start));
+    }
+
+    /**
+     * @brief 将多边形面扇形三角化
+     * @details 面的各角已按顺序写入indices末尾, 超过三个角时改写为(0, i, i + 1)的三角形序列
+     * @param indices 索引源
+     * @param faceStart 该面在索引源中的起点
+     * @param cornerSize 每个角的索引数量
+     */
+    void triangulateFace(vector<unsigned int>& indices, size_t faceStart, size_t cornerSize) {
+        if (cornerSize == 0) return;
+        size_t cornerCount = (indices.size() - faceStart) / cornerSize;
+        if (cornerCount <= 3) return;
+
+        vector<unsigned int> face(indices.begin() + static_cast<ptrdiff_t>(faceStart), indices.end());
+        indices.resize(faceStart);
+        for (size_t i = 1; i + 1 < cornerCount; i++) {
+            for (size_t corner : {size_t{0}, i, i + 1}) {
+                indices.insert(indices.end(), face.begin() + static_cast<ptrdiff_t>(corner * cornerSize), face.begin() + static_cast<ptrdiff_t>((corner + 1) * cornerSize));
+            }
+        }
+    }
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLoader(std::string_view source, bool parallel) {
     if (source.empty()) {
         glog.log<DefaultLevel::Error>("错误: obj模型源为空");
         std::terminate();
     }
-    return ObjModelLoader::parser(source);
+    return ObjModelLoader::parser(source, parallel);
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::ObjModelCacheLoader(const std::filesystem::path &path, bool isOptimize) {
+    filesystem::path cachePath = MeshCache::cachePath(path);
+    if (auto models = MeshCache::read(cachePath, path)) {
+        glog.log<DefaultLevel::Debug>("从网格缓存载入模型: " + cachePath.string());
+        return std::move(*models);
+    }
+
+    MappedFile source(path);
+    if (!source.isOpen()) {
+        glog.log<DefaultLevel::Error>("错误: obj模型无法打开: " + path.string());
+        std::terminate();
+    }
+    auto models = ObjModelLoader(source.view());
+    VertexGenerator::generate(models);
+    if (isOptimize) {
+        MeshOptimizer::optimize(models);
+    }
+    MeshOptimizer::buildLods(models);
+    MeshOptimizer::buildMeshlets(models);
+    if (!isOptimize) return models;
+    if (MeshCache::write(cachePath, MeshCache::stamp(path, source.view()), models)) {
+        glog.log<DefaultLevel::Debug>("已写入网格缓存: " + cachePath.string());
+    } else {
+        glog.log<DefaultLevel::Warn>("网格缓存写入失败: " + cachePath.string());
+    }
+    return models;
+}
+
+void ModelParser::ObjModelStreamLoader(std::istream &source, const ObjectCallback &callback, size_t chunkSize) {
+    class ObjModelStreamLoader loader(callback);
+    loader.parser(source, chunkSize == 0 ? defaultChunkSize : chunkSize);
+}
+
+void ModelParser::ObjModelStreamLoader(const std::filesystem::path &path, const ObjectCallback &callback, size_t chunkSize) {
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) {
+        glog.log<DefaultLevel::Error>("错误: obj模型无法打开: " + path.string());
+        std::terminate();
+    }
+    ObjModelStreamLoader(file, callback, chunkSize);
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLegacyLoader(const std::string &source) {
+    if (source.empty()) {
+        glog.log<DefaultLevel::Error>("错误: obj模型源为空");
+        std::terminate();
+    }
+    return ObjModelLegacyLoader::parser(source);
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLoader::parser(std::string_view source, bool parallel) {
+    vector<ObjectRange> objects = objectScan(source);
+    vector<optional<VertexLayout<float>>> layouts(objects.size());
+
+    auto process = [&objects, &layouts](size_t i) {
+        layouts[i].emplace(objectProcess(objects[i]));
+    };
+    if (parallel) {
+        ThreadPool::shared().parallelFor(objects.size(), process);
+    } else {
+        for (size_t i = 0; i < objects.size(); i++) {
+            process(i);
+        }
+    }
+
+    map<string, VertexLayout<float>> models{};
+    for (size_t i = 0; i < objects.size(); i++) {
+        models.emplace(string(objects[i].name), std::move(*layouts[i]));
+    }
+    return models;
+}
+
+std::vector<ModelParser::ObjectRange> ModelParser::ObjModelLoader::objectScan(std::string_view source) {
+    vector<ObjectRange> objects{};
+    VertexCounter v_size{0, 0}, t_size{0, 0}, n_size{0, 0};
+    const char* sourceEnd = source.data() + source.size();
+
+    auto close = [&](const char* bodyEnd) {
+        if (objects.empty()) return;
+        ObjectRange& object = objects.back();
+        object.body = string_view(object.body.data(), bodyEnd - object.body.data());
+        v_size.start += object.v.count;
+        t_size.start += object.t.count;
+        n_size.start += object.n.count;
+    };
+
+    string_view line;
+    while (nextLine(source, line)) {
+        if (line.empty()) continue;
+        switch (line[0]) {
+            case 'o': {
+                if (!isKeyword(line, "o")) break;
+                close(line.data());
+                objects.push_back(ObjectRange{objectName(line), string_view(source.data(), 0), {0, v_size.start}, {0, t_size.start}, {0, n_size.start}, 0});
+                break;
+            }
+            case 'v': {
+                if (objects.empty() || line.size() < 2) break;
+                if (isSpace(line[1])) objects.back().v.count++;
+                else if (isKeyword(line, "vt")) objects.back().t.count++;
+                else if (isKeyword(line, "vn")) objects.back().n.count++;
+                break;
+            }
+            case 'f': {
+                if (!objects.empty() && isKeyword(line, "f")) objects.back().faces++;
+                break;
+            }
+            default: break;
+        }
+    }
+    close(sourceEnd);
+    return objects;
+}
+
+VertexLayout<float> ModelParser::ObjModelLoader::objectProcess(const ObjectRange& object) {
+    vector<float> vertices{};
+    vector<float> texCoord{};
+    vector<float> normal{};
+    vector<unsigned int> indices;
+    vertices.reserve(object.v.count * 3);
+    texCoord.reserve(object.t.count * 2);
+    normal.reserve(object.n.count * 3);
+    indices.reserve(object.faces * 3 * ((object.v.count != 0) + (object.t.count != 0) + (object.n.count != 0)));
+
+    VertexCounter local_v{0, object.v.start}, local_t{0, object.t.start}, local_n{0, object.n.start};
+
+    string_view source = object.body;
+    string_view line;
+    while (nextLine(source, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        lineProcess(line, vertices, texCoord, normal, indices, local_v, local_t, local_n);
+    }
+
+    return layoutBuild(std::move(vertices), std::move(texCoord), std::move(normal), std::move(indices));
+}
+
+VertexLayout<float> ModelParser::ObjModelLoader::layoutBuild(std::vector<float> &&vertices, std::vector<float> &&texCoord, std::vector<float> &&normal, std::vector<unsigned int> &&indices) {
+    auto builder = VertexLayout<float>::builder();
+    if (!vertices.empty()) {
+        // 坐标刚解析完仍在缓存中, 顺带归约出包围体
+        Bounds bounds = Bounds::fromPositions(vertices.data(), vertices.size() / 3);
+        builder.attachBounds(bounds, BoundingSphere::fromPositions(vertices.data(), vertices.size() / 3, 3, bounds.center()));
+        builder.appendElement("vertices", 3)
+            .attachSource("vertices", std::move(vertices));
+    }
+    if (!texCoord.empty()) {
+        builder.appendElement("texCoord", 2)
+            .attachSource("texCoord", std::move(texCoord));
+    }
+    if (!normal.empty()) {
+        builder.appendElement("normal", 3)
+            .attachSource("normal", std::move(normal));
+    }
+    if (!indices.empty()) {
+        builder.attachIndices(std::move(indices));
+    }
+    return builder.build();
 }
 
-std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLoader::parser(const std::string &source) {
+void ModelParser::ObjModelLoader::lineProcess(std::string_view line, vector<float>& vertices, vector<float>& texCoord, vector<float>& normal, vector<unsigned int> &indices, VertexCounter& v, VertexCounter& t, VertexCounter& n) {
+    const char* it = line.data();
+    const char* end = line.data() + line.size();
+    if (isKeyword(line, "v")) {  // 顶点坐标
+        it += 1;
+        float x = parseFloat(it, end);
+        float y = parseFloat(it, end);
+        float z = parseFloat(it, end);
+        vertices.push_back(x);
+        vertices.push_back(y);
+        vertices.push_back(z);
+        v.count++;
+    }
+    else if (isKeyword(line, "vt")) {  // 纹理坐标
+        it += 2;
+        float vertex_u = parseFloat(it, end);
+        float vertex_v = parseFloat(it, end);
+        texCoord.push_back(vertex_u);
+        texCoord.push_back(vertex_v);
+        t.count++;
+    }
+    else if (isKeyword(line, "vn")) {  // 法线
+        it += 2;
+        float x = parseFloat(it, end);
+        float y = parseFloat(it, end);
+        float z = parseFloat(it, end);
+        normal.push_back(x);
+        normal.push_back(y);
+        normal.push_back(z);
+        n.count++;
+    }
+    else if (isKeyword(line, "f")) {  // 面
+        it += 1;
+        size_t faceStart = indices.size();
+        size_t cornerSize{0};
+        while (true) {
+            skipSpace(it, end);
+            if (it == end) break;
+            if (cornerSize == 0) cornerSize = indices.size() - faceStart;
+            size_t counterIndex{0};
+            while (it != end && !isSpace(*it)) {
+                if (*it == '/') {
+                    counterIndex++;
+                    it++;
+                    continue;
+                }
+                long long index{};
+                auto [ptr, ec] = from_chars(it, end, index);
+                if (ec != errc()) {
+                    it++;
+                    continue;
+                }
+                it = ptr;
+                switch (counterIndex) {
+                    case 0: {
+                        indices.push_back(localIndex(index, v.start, v.count));
+                        break;
+                    }
+                    case 1: {
+                        indices.push_back(localIndex(index, t.start, t.count));
+                        break;
+                    }
+                    case 2: {
+                        indices.push_back(localIndex(index, n.start, n.count));
+                        break;
+                    }
+                    default: break;
+                }
+            }
+        }
+        if (cornerSize == 0) cornerSize = indices.size() - faceStart;
+        triangulateFace(indices, faceStart, cornerSize);
+    }
+}
+
+void ModelParser::ObjModelStreamLoader::parser(std::istream &source, size_t chunkSize) {
+    vector<char> chunk(chunkSize);
+    string carry{};
+    while (source) {
+        source.read(chunk.data(), static_cast<streamsize>(chunk.size()));
+        auto size = static_cast<size_t>(source.gcount());
+        if (size == 0) break;
+
+        string_view rest(chunk.data(), size);
+        size_t first = rest.find('\n');
+        if (first == string_view::npos) {  // 整块都在同一行内
+            carry.append(rest);
+            continue;
+        }
+        carry.append(rest.substr(0, first));
+        lineProcess(carry);
+        carry.clear();
+        rest.remove_prefix(first + 1);
+
+        size_t last = rest.rfind('\n');
+        string_view lines = last == string_view::npos ? string_view{} : rest.substr(0, last + 1);
+        carry.append(rest.substr(lines.size()));
+        string_view line;
+        while (nextLine(lines, line)) {
+            lineProcess(line);
+        }
+    }
+    lineProcess(carry);
+    objectEmit();
+}
+
+void ModelParser::ObjModelStreamLoader::lineProcess(std::string_view line) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty() || line[0] == '#') return;
+    if (isKeyword(line, "o")) {
+        objectEmit();
+        _name = string(objectName(line));
+        _isOpen = true;
+        return;
+    }
+    if (!_isOpen) return;
+    ObjModelLoader::lineProcess(line, _vertices, _texCoord, _normal, _indices, _v, _t, _n);
+}
+
+void ModelParser::ObjModelStreamLoader::objectEmit() {
+    if (!_isOpen) return;
+    _isOpen = false;
+    _v = {0, _v.start + _v.count};
+    _t = {0, _t.start + _t.count};
+    _n = {0, _n.start + _n.count};
+    // 移动后的容器不保证为空, 显式交换出去使下一个对象从空容器开始
+    VertexLayout<float> layout = ObjModelLoader::layoutBuild(
+        exchange(_vertices, {}), exchange(_texCoord, {}), exchange(_normal, {}), exchange(_indices, {}));
+    _callback(std::move(_name), std::move(layout));
+    _name.clear();
+}
+
+std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLegacyLoader::parser(const std::string &source) {
     map<string, VertexLayout<float>> models{};
     istringstream sourceIss(source);
     string line;
@@ -27,7 +432,7 @@ std::map<std::string, VertexLayout<float> > ModelParser::ObjModelLoader::parser(
     return models;
 }
 
-void ModelParser::ObjModelLoader::objectProcess(const string& name, istringstream &source, std::map<std::string, VertexLayout<float>>& models, VertexCounter& v, VertexCounter& t, VertexCounter& n) {
+void ModelParser::ObjModelLegacyLoader::objectProcess(const string& name, istringstream &source, std::map<std::string, VertexLayout<float>>& models, VertexCounter& v, VertexCounter& t, VertexCounter& n) {
     auto builder = VertexLayout<float>::builder();
     vector<float> vertices{};
     vector<float> texCoord{};
@@ -73,7 +478,7 @@ void ModelParser::ObjModelLoader::objectProcess(const string& name, istringstrea
     models.emplace(name, std::move(builder.build()));
 }
 
-void ModelParser::ObjModelLoader::lineProcess(const std::string &line, vector<float>& vertices, vector<float>& texCoord, vector<float>& normal, vector<unsigned int> &indices, VertexCounter& v, VertexCounter& t, VertexCounter& n) {
+void ModelParser::ObjModelLegacyLoader::lineProcess(const std::string &line, vector<float>& vertices, vector<float>& texCoord, vector<float>& normal, vector<unsigned int> &indices, VertexCounter& v, VertexCounter& t, VertexCounter& n) {
     istringstream lineIss(line);
     string token;
     while (getline(lineIss, token, ' ')) {
@@ -102,7 +507,10 @@ void ModelParser::ObjModelLoader::lineProcess(const std::string &line, vector<fl
         }
         else if (token == "f") {  // 面
             string fLine;
+            size_t faceStart = indices.size();
+            size_t cornerSize{0};
             while (getline(lineIss, token, ' ')) {
+                if (cornerSize == 0) cornerSize = indices.size() - faceStart;
                 string index;
                 istringstream tokenIss(token);
                 size_t counterIndex{0};
@@ -125,9 +533,8 @@ void ModelParser::ObjModelLoader::lineProcess(const std::string &line, vector<fl
                     counterIndex++;
                 }
             }
+            if (cornerSize == 0) cornerSize = indices.size() - faceStart;
+            triangulateFace(indices, faceStart, cornerSize);
         }
     }
 }
-
-
-
@@ -0,0 +1,325 @@
+#include "VertexGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Hash.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEARN_GENERATOR_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+    /**
+     * @brief 4宽向量
+     * @details 仅使用xyz, w恒为0; SSE2下为__m128的薄包装
+     */
+    struct Lane {
+#ifdef LEARN_GENERATOR_SSE2
+        __m128 v;
+
+        static Lane zero() {
+            return {_mm_setzero_ps()};
+        }
+
+        static Lane load3(const float* p) {
+            return {_mm_setr_ps(p[0], p[1], p[2], 0.0f)};
+        }
+
+        static Lane load4(const float* p) {
+            return {_mm_loadu_ps(p)};
+        }
+
+        void store4(float* p) const {
+            _mm_storeu_ps(p, v);
+        }
+
+        Lane operator + (Lane other) const {
+            return {_mm_add_ps(v, other.v)};
+        }
+
+        Lane operator - (Lane other) const {
+            return {_mm_sub_ps(v, other.v)};
+        }
+
+        Lane operator * (float scale) const {
+            return {_mm_mul_ps(v, _mm_set1_ps(scale))};
+        }
+
+        [[nodiscard]] Lane cross(Lane other) const {
+            __m128 a = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 b = _mm_shuffle_ps(other.v, other.v, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 c = _mm_sub_ps(_mm_mul_ps(v, b), _mm_mul_ps(a, other.v));
+            return {_mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1))};
+        }
+
+        [[nodiscard]] float dot(Lane other) const {
+            __m128 m = _mm_mul_ps(v, other.v);
+            __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+            s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_cvtss_f32(s);
+        }
+#else
+        float v[4];
+
+        static Lane zero() {
+            return {{0.0f, 0.0f, 0.0f, 0.0f}};
+        }
+
+        static Lane load3(const float* p) {
+            return {{p[0], p[1], p[2], 0.0f}};
+        }
+
+        static Lane load4(const float* p) {
+            return {{p[0], p[1], p[2], p[3]}};
+        }
+
+        void store4(float* p) const {
+            memcpy(p, v, sizeof(v));
+        }
+
+        Lane operator + (Lane other) const {
+            return {{v[0] + other.v[0], v[1] + other.v[1], v[2] + other.v[2], v[3] + other.v[3]}};
+        }
+
+        Lane operator - (Lane other) const {
+            return {{v[0] - other.v[0], v[1] - other.v[1], v[2] - other.v[2], v[3] - other.v[3]}};
+        }
+
+        Lane operator * (float scale) const {
+            return {{v[0] * scale, v[1] * scale, v[2] * scale, v[3] * scale}};
+        }
+
+        [[nodiscard]] Lane cross(Lane other) const {
+            return {{v[1] * other.v[2] - v[2] * other.v[1], v[2] * other.v[0] - v[0] * other.v[2], v[0] * other.v[1] - v[1] * other.v[0], 0.0f}};
+        }
+
+        [[nodiscard]] float dot(Lane other) const {
+            return v[0] * other.v[0] + v[1] * other.v[1] + v[2] * other.v[2] + v[3] * other.v[3];
+        }
+#endif
+
+        [[nodiscard]] Lane normalized(Lane fallback) const {
+            float length = std::sqrt(dot(*this));
+            return length > 1e-20f ? *this * (1.0f / length) : fallback;
+        }
+    };
+
+    /**
+     * @brief 按区间并行
+     * @details 区间数量按rangeSize划分, 不足一个区间时直接在调用线程上执行
+     * @param count 元素数量
+     * @param func 区间任务, 签名为void(size_t begin, size_t end)
+     */
+    template<typename Func>
+    void rangeFor(size_t count, Func&& func) {
+        const size_t ranges = (count + VertexGenerator::rangeSize - 1) / VertexGenerator::rangeSize;
+        if (ranges <= 1) {
+            func(static_cast<size_t>(0), count);
+            return;
+        }
+        ThreadPool::shared().parallelFor(ranges, [&func, count, ranges](size_t r) {
+            func(r * count / ranges, (r + 1) * count / ranges);
+        });
+    }
+
+    /**
+     * @brief 顶点到三角形的邻接表
+     * @details 压缩行存储, 以计数排序构建
+     */
+    struct VertexTriangles {
+        vector<unsigned int> offsets;
+        vector<unsigned int> triangles;
+
+        VertexTriangles(const unsigned int* indices, size_t indexCount, size_t vertexCount, const unsigned int* group): offsets(vertexCount + 1, 0), triangles(indexCount) {
+            for (size_t i = 0; i < indexCount; i++) {
+                offsets[group[indices[i]] + 1]++;
+            }
+            for (size_t v = 0; v < vertexCount; v++) {
+                offsets[v + 1] += offsets[v];
+            }
+            vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indexCount; i++) {
+                triangles[cursor[group[indices[i]]]++] = static_cast<unsigned int>(i / 3);
+            }
+        }
+    };
+
+    /**
+     * @brief 将坐标相同的顶点归为一组
+     * @details 以坐标的位模式做开放寻址哈希, 每个顶点映射到组内下标最小的顶点; -0与+0视为相同
+     */
+    vector<unsigned int> positionGroups(const float* positions, size_t vertexCount, size_t stride) {
+        constexpr unsigned int empty = ~0u;
+        size_t capacity = 16;
+        while (capacity < vertexCount * 2) capacity <<= 1;
+        vector<unsigned int> table(capacity, empty);
+
+        auto key = [positions, stride](size_t v) {
+            const float* p = positions + v * stride;
+            return std::array<float, 3>{p[0] + 0.0f, p[1] + 0.0f, p[2] + 0.0f};
+        };
+        vector<unsigned int> group(vertexCount);
+        for (size_t v = 0; v < vertexCount; v++) {
+            const std::array<float, 3> position = key(v);
+            size_t slot = hashing::fnv1a(position.data(), sizeof(position)) & (capacity - 1);
+            while (table[slot] != empty && key(table[slot]) != position) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            if (table[slot] == empty) table[slot] = static_cast<unsigned int>(v);
+            group[v] = table[slot];
+        }
+        return group;
+    }
+}
+
+void VertexGenerator::computeNormals(const unsigned int* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t stride, float* normals) {
+    const size_t triangleCount = indexCount / 3;
+    vector<float> faces(triangleCount * 4);
+    rangeFor(triangleCount, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            Lane p0 = Lane::load3(positions + indices[t * 3] * stride);
+            Lane p1 = Lane::load3(positions + indices[t * 3 + 1] * stride);
+            Lane p2 = Lane::load3(positions + indices[t * 3 + 2] * stride);
+            // 叉乘的模为三角形面积的两倍, 直接累加即为面积加权
+            (p1 - p0).cross(p2 - p0).store4(faces.data() + t * 4);
+        }
+    });
+
+    const vector<unsigned int> group = positionGroups(positions, vertexCount, stride);
+    const VertexTriangles adjacency(indices, triangleCount * 3, vertexCount, group.data());
+    const Lane up = Lane::load3(array<float, 3>{0.0f, 0.0f, 1.0f}.data());
+    rangeFor(vertexCount, [&](size_t begin, size_t end) {
+        float out[4];
+        for (size_t v = begin; v < end; v++) {
+            const unsigned int g = group[v];
+            Lane sum = Lane::zero();
+            for (unsigned int k = adjacency.offsets[g]; k < adjacency.offsets[g + 1]; k++) {
+                sum = sum + Lane::load4(faces.data() + adjacency.triangles[k] * 4);
+            }
+            sum.normalized(up).store4(out);
+            memcpy(normals + v * 3, out, 3 * sizeof(float));
+        }
+    });
+}
+
+void VertexGenerator::computeTangents(const unsigned int* indices, size_t indexCount, const float* positions, const float* texCoords, const float* normals, size_t vertexCount, size_t stride, float* tangents) {
+    const size_t triangleCount = indexCount / 3;
+    vector<float> faces(triangleCount * 8);
+    rangeFor(triangleCount, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            const unsigned int a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+            Lane e1 = Lane::load3(positions + b * stride) - Lane::load3(positions + a * stride);
+            Lane e2 = Lane::load3(positions + c * stride) - Lane::load3(positions + a * stride);
+            const float* uv0 = texCoords + a * stride;
+            const float* uv1 = texCoords + b * stride;
+            const float* uv2 = texCoords + c * stride;
+            float du1 = uv1[0] - uv0[0], dv1 = uv1[1] - uv0[1];
+            float du2 = uv2[0] - uv0[0], dv2 = uv2[1] - uv0[1];
+            float det = du1 * dv2 - du2 * dv1;
+            // 只取行列式的符号而不除以它, 使贡献按几何面积加权, 同时避免UV退化时数值爆炸
+            float sign = det > 0.0f ? 1.0f : (det < 0.0f ? -1.0f : 0.0f);
+            (e1 * (dv2 * sign) - e2 * (dv1 * sign)).store4(faces.data() + t * 8);
+            (e2 * (du1 * sign) - e1 * (du2 * sign)).store4(faces.data() + t * 8 + 4);
+        }
+    });
+
+    vector<unsigned int> identity(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) identity[v] = static_cast<unsigned int>(v);
+    const VertexTriangles adjacency(indices, triangleCount * 3, vertexCount, identity.data());
+    rangeFor(vertexCount, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            Lane tangent = Lane::zero(), bitangent = Lane::zero();
+            for (unsigned int k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; k++) {
+                tangent = tangent + Lane::load4(faces.data() + adjacency.triangles[k] * 8);
+                bitangent = bitangent + Lane::load4(faces.data() + adjacency.triangles[k] * 8 + 4);
+            }
+            Lane normal = Lane::load3(normals + v * stride);
+            // 无有效UV时任取一条与法线垂直的方向
+            const float* n = normals + v * stride;
+            Lane axis = Lane::load3(std::abs(n[0]) < 0.9f ? array<float, 3>{1.0f, 0.0f, 0.0f}.data() : array<float, 3>{0.0f, 1.0f, 0.0f}.data());
+            Lane fallback = (axis - normal * normal.dot(axis)).normalized(axis);
+            tangent = (tangent - normal * normal.dot(tangent)).normalized(fallback);
+
+            float out[4];
+            tangent.store4(out);
+            out[3] = normal.cross(tangent).dot(bitangent) < 0.0f ? -1.0f : 1.0f;
+            memcpy(tangents + v * 4, out, sizeof(out));
+        }
+    });
+}
+
+bool VertexGenerator::generate(VertexLayout<float> &layout, bool isTangent) {
+    if (!layout.contain("vertices") || layout["vertices"].length < 3) return false;
+    const bool isNormal = !layout.contain("normal");
+    isTangent = isTangent && !layout.contain("tangent") && layout.contain("texCoord") && layout["texCoord"].length >= 2
+        && (isNormal || layout["normal"].length == 3);
+    if (!isNormal && !isTangent) return false;
+
+    const vector<float>& buffer = layout.WeldIndices();
+    if (buffer.empty()) return false;
+    const vector<unsigned int>& indices = layout.bufferOfIndices();
+    const size_t stride = layout.elements()[0].step / sizeof(float);
+    const size_t vertexCount = buffer.size() / stride;
+    const size_t outStride = stride + (isNormal ? 3 : 0) + (isTangent ? 4 : 0);
+    const size_t positionOrigin = layout["vertices"].origin / sizeof(float);
+    const size_t normalOrigin = isNormal ? stride : layout["normal"].origin / sizeof(float);
+    const size_t tangentOrigin = stride + (isNormal ? 3 : 0);
+
+    vector<float> out(vertexCount * outStride);
+    rangeFor(vertexCount, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; v++) {
+            memcpy(out.data() + v * outStride, buffer.data() + v * stride, stride * sizeof(float));
+        }
+    });
+
+    if (isNormal) {
+        vector<float> normals(vertexCount * 3);
+        computeNormals(indices.data(), indices.size(), buffer.data() + positionOrigin, vertexCount, stride, normals.data());
+        for (size_t v = 0; v < vertexCount; v++) {
+            memcpy(out.data() + v * outStride + normalOrigin, normals.data() + v * 3, 3 * sizeof(float));
+        }
+    }
+    if (isTangent) {
+        vector<float> tangents(vertexCount * 4);
+        computeTangents(indices.data(), indices.size(),
+            out.data() + positionOrigin,
+            out.data() + layout["texCoord"].origin / sizeof(float),
+            out.data() + normalOrigin,
+            vertexCount, outStride, tangents.data());
+        for (size_t v = 0; v < vertexCount; v++) {
+            memcpy(out.data() + v * outStride + tangentOrigin, tangents.data() + v * 4, 4 * sizeof(float));
+        }
+    }
+
+    auto builder = VertexLayout<float>::builder();
+    for (const auto& e : layout.elements()) {
+        builder.appendElement(e.identifier, e.length, e.format);
+    }
+    if (isNormal) builder.appendElement("normal", 3);
+    if (isTangent) builder.appendElement("tangent", 4);
+
+    vector<VertexLayout<float>::LodLevel> lods = layout.lods();
+    vector<VertexLayout<float>::Meshlet> meshlets = layout.meshlets();
+    VertexLayout<float> rebuilt = builder
+        .attachAssembled(std::move(out), vector<unsigned int>(indices))
+        .attachBounds(layout.bounds(), layout.sphere())
+        .build();
+    rebuilt.lods(std::move(lods));
+    rebuilt.meshlets(std::move(meshlets));
+    layout = std::move(rebuilt);
+    return true;
+}
+
+void VertexGenerator::generate(std::map<std::string, VertexLayout<float>> &models, bool isTangent) {
+    for (auto& [name, layout] : models) {
+        generate(layout, isTangent);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <VertexLayout.hpp>
+
+/**
+ * @brief 异步模型载入
+ * @details 在共享线程池上完成解析, 网格优化与上传前的CPU准备, 完成的对象进入队列;
+ *          渲染线程每帧调用drain在时间预算内取出对象完成GPU上传, 使窗口在大型模型载入期间仍能持续出帧.
+ *          载入任务抛出的异常不会丢失, 而是进入同一队列, 在之后的drain中于渲染线程重新抛出.
+ *          载入任务持有this, 析构时会等待所有载入任务结束
+ */
+class AsyncModelLoader {
+    public:
+        /**
+         * @brief 工作线程上的准备回调
+         * @details 参数依次为对象名与该对象的缓冲区组装布局, 不得调用opengl
+         */
+        using Prepare = std::function<void(const std::string&, VertexLayout<float>&)>;
+
+        /**
+         * @brief 渲染线程上的上传回调
+         * @details 参数依次为对象名与该对象的缓冲区组装布局
+         */
+        using Upload = std::function<void(std::string, VertexLayout<float>)>;
+
+        static constexpr std::chrono::microseconds defaultUploadBudget{2000};
+
+        AsyncModelLoader() = default;
+        ~AsyncModelLoader();
+
+        AsyncModelLoader(const AsyncModelLoader&) = delete;
+        AsyncModelLoader& operator = (const AsyncModelLoader&) = delete;
+
+        /**
+         * @brief 提交模型载入
+         * @details .glb经ModelParser::GlbModelLoader载入, 其余经ModelParser::ObjModelCacheLoader载入; 之后各对象在线程池上并行执行prepare, 完成一个即入队一个
+         * @param path 模型路径
+         * @param prepare 工作线程上的准备回调, 可为空
+         */
+        void load(const std::filesystem::path& path, Prepare prepare = {});
+
+        /**
+         * @brief 在时间预算内取出已完成的对象
+         * @details 须在渲染线程调用. 每次调用至少取出一个对象以保证进度, 因此单个对象的上传耗时可能超出预算.
+         *          载入失败的任务在此重新抛出其异常, 每次调用最多抛出一个, 之前已取出的对象已完成上传
+         * @param upload 渲染线程上的上传回调
+         * @param budget 时间预算
+         * @return 本次取出的对象数量
+         */
+        size_t drain(const Upload& upload, std::chrono::microseconds budget = defaultUploadBudget);
+
+        /**
+         * @brief 获取等待上传的对象数量
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 对象数量
+         */
+        [[nodiscard]] size_t pending();
+
+        /**
+         * @brief 是否已全部载入并上传
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 没有进行中的载入任务, 且对象与未抛出的异常均已取出时为true
+         */
+        [[nodiscard]] bool isIdle();
+
+    private:
+        struct Item {
+            std::string name;
+            VertexLayout<float> layout;
+        };
+
+        std::mutex _mtx;
+        std::deque<Item> _ready;
+        std::deque<std::exception_ptr> _failures;
+        std::atomic<size_t> _loading{0};
+        std::vector<std::future<void>> _tasks;
+
+        void push(std::string name, VertexLayout<float> layout);
+};
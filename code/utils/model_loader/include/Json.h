@@ -0,0 +1,136 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 最小JSON值
+ * @details 仅为glTF等资源描述而设计的只读DOM, 对象保持源中的键顺序, 按键查找为线性查找.
+ *          访问不存在的键或越界下标时返回空值而非抛出, 便于按默认值读取可选字段
+ */
+class Json {
+    public:
+        enum Type {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        Json() = default;
+
+        /**
+         * @brief 解析JSON文本
+         * @details 支持完整的JSON语法, 包括\\u转义与代理对; 文本末尾只允许空白
+         * @param source JSON文本
+         * @return 解析失败时为空
+         */
+        static std::optional<Json> parse(std::string_view source);
+
+        [[nodiscard]] Type type() const {
+            return _type;
+        }
+
+        [[nodiscard]] bool isNull() const {
+            return _type == Null;
+        }
+
+        /**
+         * @brief 获取数组或对象的元素数量
+         * @details 其余类型为0
+         * @return 元素数量
+         */
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * @brief 对象是否包含键
+         * @details 他似乎不需要详细注释[划掉]
+         * @param key 键
+         * @return 他似乎不需要注释[划掉]
+         */
+        [[nodiscard]] bool contains(std::string_view key) const;
+
+        /**
+         * @brief 通过下标操作符按键获取成员
+         * @details 非对象或不存在该键时返回空值
+         * @param key 键
+         * @return 成员引用
+         */
+        const Json& operator [] (std::string_view key) const;
+
+        /**
+         * @brief 通过下标操作符获取数组元素
+         * @details 非数组或越界时返回空值
+         * @param index 下标
+         * @return 元素引用
+         */
+        const Json& operator [] (size_t index) const;
+
+        /**
+         * @brief 获取数值
+         * @details 他似乎不需要详细注释[划掉]
+         * @param fallback 非数值时的默认值
+         * @return 数值
+         */
+        [[nodiscard]] double number(double fallback = 0.0) const {
+            return _type == Number ? _number : fallback;
+        }
+
+        /**
+         * @brief 是否为可作下标的数值
+         * @details 有限, 非负, 为整数且可由size_t表示; JSON数值为double, 直接转换超出范围的值是未定义行为
+         * @return 他似乎不需要注释[划掉]
+         */
+        [[nodiscard]] bool isIndex() const {
+            return _type == Number && std::isfinite(_number) && _number >= 0.0 && std::floor(_number) == _number
+                && _number < std::ldexp(1.0, std::numeric_limits<size_t>::digits);
+        }
+
+        /**
+         * @brief 获取非负整数
+         * @details 需要区分缺失与无效时先以isIndex检查
+         * @param fallback 不是可作下标的数值时的默认值
+         * @return 整数
+         */
+        [[nodiscard]] size_t index(size_t fallback = 0) const {
+            return isIndex() ? static_cast<size_t>(_number) : fallback;
+        }
+
+        [[nodiscard]] bool boolean(bool fallback = false) const {
+            return _type == Bool ? _boolean : fallback;
+        }
+
+        /**
+         * @brief 获取字符串
+         * @details 非字符串时为空字符串
+         * @return 字符串引用
+         */
+        [[nodiscard]] const std::string& string() const;
+
+        /**
+         * @brief 获取对象成员
+         * @details 按源中的顺序排列, 非对象时为空
+         * @return 成员数组引用
+         */
+        [[nodiscard]] const std::vector<std::pair<std::string, Json>>& members() const {
+            return _members;
+        }
+
+    private:
+        Type _type{Null};
+        bool _boolean{false};
+        double _number{};
+        std::string _string;
+        std::vector<Json> _elements;
+        std::vector<std::pair<std::string, Json>> _members;
+
+        class Parser;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <VertexLayout.hpp>
+
+/**
+ * @brief 二进制网格缓存
+ * @details 首次导入文本模型后写在源文件旁, 保存各对象焊接完毕的交错顶点数据, 索引, 布局描述, 细节层级, 簇与包围体.
+ *          之后的运行直接映射缓存文件读取, 不再进行任何文本解析.
+ *          顶点与索引默认经MeshCodec压缩, 以解码开销换取更小的文件与更快的冷启动读取.
+ *          文件按本机字节序写入, 仅作为本机缓存使用, 不应分发
+ */
+class MeshCache {
+    public:
+        static constexpr uint32_t magic = 0x48534D4C;  // "LMSH"
+        static constexpr uint32_t version = 8;
+        static constexpr uint32_t flagCompressed = 1;
+
+        /**
+         * @brief 源文件戳
+         * @details 大小与修改时间一致时直接视为有效; 否则再比较内容哈希, 避免仅被touch过的源导致重新导入
+         */
+        struct SourceStamp {
+            uint64_t size{};
+            int64_t mtime{};
+            uint64_t hash{};
+        };
+
+        /**
+         * @brief 获取源文件对应的缓存路径
+         * @details 他似乎不需要详细注释[划掉]
+         * @param source 源文件路径
+         * @return 缓存路径
+         */
+        static std::filesystem::path cachePath(const std::filesystem::path& source);
+
+        /**
+         * @brief 计算源文件戳
+         * @details 他似乎不需要详细注释[划掉]
+         * @param source 源文件路径
+         * @param content 源文件内容
+         * @return 源文件戳
+         */
+        static SourceStamp stamp(const std::filesystem::path& source, std::string_view content);
+
+        /**
+         * @brief 写入缓存
+         * @details 会对尚未组装的布局进行焊接组装; 先写入临时文件再替换, 中途失败不会留下损坏的缓存
+         * @param path 缓存路径
+         * @param stamp 源文件戳
+         * @param models 以对象名为键的缓冲区组装布局表
+         * @param isCompressed 是否以MeshCodec压缩顶点与索引
+         * @return 是否写入成功
+         */
+        static bool write(const std::filesystem::path& path, const SourceStamp& stamp, std::map<std::string, VertexLayout<float>>& models, bool isCompressed = true);
+
+        /**
+         * @brief 读取缓存
+         * @details 缓存不存在, 版本不符, 已过期或内容损坏时返回空
+         * @param path 缓存路径
+         * @param source 源文件路径
+         * @return 以对象名为键的缓冲区组装布局表
+         */
+        static std::optional<std::map<std::string, VertexLayout<float>>> read(const std::filesystem::path& path, const std::filesystem::path& source);
+};
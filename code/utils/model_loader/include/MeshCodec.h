@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 网格数据编解码
+ * @details 面向网格缓存的无损压缩, 思路与meshoptimizer的顶点/索引编码相同.
+ *          顶点: 按块处理, 块内每个32位字单独成列, 与上一顶点同位置的字做整数差后zigzag, 再拆为4个字节平面,
+ *          每个平面以16字节为一组按0/2/4/8位宽打包, 每组位宽用2位记录在平面头. 相邻顶点相近时高位平面大多只需0~4位.
+ *          索引: 与上一索引做差后zigzag, 再以LEB128变长字节写出, 经顶点拉取重排后绝大多数索引只需1字节.
+ *          顶点解码只有定长分组解包与逐列前缀和, 支持SSE2时以向量完成, 可达数GB/s
+ */
+class MeshCodec {
+    public:
+        static constexpr unsigned char vertexTag = 0xA0;
+        static constexpr unsigned char indexTag = 0xE0;
+        static constexpr size_t groupSize = 16;
+        static constexpr size_t maxBlockVertices = 256;
+
+        /**
+         * @brief 编码顶点缓冲区
+         * @details 他似乎不需要详细注释[划掉]
+         * @param vertices 顶点数据
+         * @param vertexCount 顶点数量
+         * @param vertexSize 单个顶点字节数, 需为4的倍数
+         * @return 编码结果, vertexSize不是4的倍数时为空
+         */
+        static std::vector<unsigned char> encodeVertices(const void* vertices, size_t vertexCount, size_t vertexSize);
+
+        /**
+         * @brief 解码顶点缓冲区
+         * @details 输入越界或格式不符时返回false, 此时输出内容未定义
+         * @param out 输出地址, 需至少vertexCount * vertexSize字节
+         * @param vertexCount 顶点数量
+         * @param vertexSize 单个顶点字节数
+         * @param data 编码数据
+         * @param size 编码数据字节数
+         * @return 是否解码成功
+         */
+        static bool decodeVertices(void* out, size_t vertexCount, size_t vertexSize, const unsigned char* data, size_t size);
+
+        /**
+         * @brief 编码索引
+         * @details 他似乎不需要详细注释[划掉]
+         * @param indices 索引
+         * @param count 索引数量
+         * @return 编码结果
+         */
+        static std::vector<unsigned char> encodeIndices(const unsigned int* indices, size_t count);
+
+        /**
+         * @brief 解码索引
+         * @details 输入越界或格式不符时返回false, 此时输出内容未定义
+         * @param out 输出地址, 需至少count个索引
+         * @param count 索引数量
+         * @param data 编码数据
+         * @param size 编码数据字节数
+         * @return 是否解码成功
+         */
+        static bool decodeIndices(unsigned int* out, size_t count, const unsigned char* data, size_t size);
+
+        /**
+         * @brief 获取顶点块大小
+         * @details 使一个块的解码工作集约为8KB, 并取16的倍数
+         * @param vertexSize 单个顶点字节数
+         * @return 块内顶点数量
+         */
+        static size_t blockVertices(size_t vertexSize);
+};
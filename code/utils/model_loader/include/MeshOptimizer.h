@@ -0,0 +1,118 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+#include <VertexLayout.hpp>
+
+/**
+ * @brief 网格优化
+ * @details 作用于已焊接的索引网格, 作为ObjModelLoader之后的可选阶段.
+ *          先按Tipsify算法重排三角形以提高变换后顶点缓存命中率, 再按首次使用顺序重排顶点以提高顶点拉取局部性.
+ *          另提供基于二次误差度量的细节层级生成与簇划分
+ */
+class MeshOptimizer {
+    public:
+        static constexpr size_t defaultCacheSize = 16;
+        static constexpr size_t defaultMeshletVertices = 64;
+        static constexpr size_t defaultMeshletTriangles = 124;
+
+        /**
+         * @brief 优化单个布局
+         * @details 布局尚未组装时会先进行焊接组装
+         * @param layout 缓冲区组装布局
+         * @param cacheSize 模拟的变换后顶点缓存大小
+         */
+        static void optimize(VertexLayout<float>& layout, size_t cacheSize = defaultCacheSize);
+
+        /**
+         * @brief 优化布局表中的所有布局
+         * @details 各对象在线程池上并行处理
+         * @param models 以对象名为键的缓冲区组装布局表
+         * @param cacheSize 模拟的变换后顶点缓存大小
+         */
+        static void optimize(std::map<std::string, VertexLayout<float>>& models, size_t cacheSize = defaultCacheSize);
+
+        /**
+         * @brief 为单个布局生成细节层级链
+         * @details 每级在上一级基础上以二次误差度量简化, 简化结果再经vertexCacheOrder重排;
+         *          简化几乎无效(边界与接缝顶点被锁定等)时提前结束.
+         *          布局尚未组装时会先进行焊接组装
+         * @param layout 缓冲区组装布局
+         * @param ratios 各级相对原网格的三角形比例, 需递减
+         * @param cacheSize 模拟的变换后顶点缓存大小
+         */
+        static void buildLods(VertexLayout<float>& layout, const std::vector<float>& ratios = {0.5f, 0.25f, 0.125f}, size_t cacheSize = defaultCacheSize);
+
+        /**
+         * @brief 为布局表中的所有布局生成细节层级链
+         * @details 各对象在线程池上并行处理
+         * @param models 以对象名为键的缓冲区组装布局表
+         * @param ratios 各级相对原网格的三角形比例, 需递减
+         */
+        static void buildLods(std::map<std::string, VertexLayout<float>>& models, const std::vector<float>& ratios = {0.5f, 0.25f, 0.125f});
+
+        /**
+         * @brief 将最细层级划分为簇
+         * @details 从未分配的三角形出发贪心生长, 优先加入新增顶点最少的相邻三角形, 直到达到顶点或三角形上限.
+         *          最细层级的索引会按簇重排为连续区间, 其末尾不完整的三角形被丢弃, 其余层级不受影响
+         * @param layout 缓冲区组装布局
+         * @param maxVertices 每簇最大顶点数
+         * @param maxTriangles 每簇最大三角形数
+         */
+        static void buildMeshlets(VertexLayout<float>& layout, size_t maxVertices = defaultMeshletVertices, size_t maxTriangles = defaultMeshletTriangles);
+
+        /**
+         * @brief 将布局表中的所有布局划分为簇
+         * @details 各对象在线程池上并行处理
+         * @param models 以对象名为键的缓冲区组装布局表
+         * @param maxVertices 每簇最大顶点数
+         * @param maxTriangles 每簇最大三角形数
+         */
+        static void buildMeshlets(std::map<std::string, VertexLayout<float>>& models, size_t maxVertices = defaultMeshletVertices, size_t maxTriangles = defaultMeshletTriangles);
+
+        /**
+         * @brief 二次误差度量网格简化
+         * @details 以边坍缩将顶点合并到相邻的已有顶点上, 因此结果可以与原网格共享顶点缓冲区.
+         *          边界顶点与位置相同但属性不同的接缝顶点被锁定, 避免产生裂缝; 会导致三角形翻转的坍缩被拒绝.
+         *          末尾不完整的三角形被丢弃
+         * @param indices 三角形索引
+         * @param positions 第一个顶点的坐标地址
+         * @param vertexCount 顶点数量
+         * @param stride 相邻顶点间隔的浮点数数量
+         * @param targetIndexCount 目标索引数量
+         * @param error 输出的最大坍缩误差, 单位与顶点坐标相同
+         * @return 简化后的三角形索引
+         */
+        static std::vector<unsigned int> simplify(const std::vector<unsigned int>& indices, const float* positions, size_t vertexCount, size_t stride, size_t targetIndexCount, float& error);
+
+        /**
+         * @brief 按变换后顶点缓存局部性重排三角形
+         * @details Tipsify: 围绕当前扇心顶点输出其全部剩余三角形, 再从刚进入缓存且剩余三角形较少的顶点中选下一扇心.
+         *          末尾不完整的三角形被丢弃
+         * @param indices 三角形索引
+         * @param vertexCount 顶点数量
+         * @param cacheSize 模拟的变换后顶点缓存大小
+         * @return 重排后的三角形索引
+         */
+        static std::vector<unsigned int> vertexCacheOrder(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize = defaultCacheSize);
+
+        /**
+         * @brief 按首次使用顺序重排顶点
+         * @details 会就地改写索引, 未被引用的顶点会被丢弃
+         * @param indices 三角形索引
+         * @param vertexCount 顶点数量
+         * @return 旧顶点到新顶点的映射, 未被引用的顶点映射为~0u
+         */
+        static std::vector<unsigned int> vertexFetchOrder(std::vector<unsigned int>& indices, size_t vertexCount);
+
+        /**
+         * @brief 计算平均缓存未命中率(ACMR)
+         * @details 以FIFO缓存模拟, 结果为每个三角形的平均顶点变换次数, 理想值约为0.5, 最差为3
+         * @param indices 三角形索引
+         * @param vertexCount 顶点数量
+         * @param cacheSize 模拟的变换后顶点缓存大小
+         * @return ACMR
+         */
+        static double acmr(const std::vector<unsigned int>& indices, size_t vertexCount, size_t cacheSize = defaultCacheSize);
+};
@@ -1,20 +1,137 @@
 #pragma once
+#include <filesystem>
+#include <functional>
+#include <istream>
+#include <sstream>
+#include <string_view>
+
 #include <VertexLayout.hpp>
 
 class ModelParser {
     public:
         ~ModelParser() = default;
-        static std::map<std::string, VertexLayout<float>> ObjModelLoader(const std::string& source);
+
+        /**
+         * @brief 流式解析的对象回调
+         * @details 参数依次为对象名与该对象的缓冲区组装布局
+         */
+        using ObjectCallback = std::function<void(std::string, VertexLayout<float>)>;
+
+        static constexpr size_t defaultChunkSize = 1 << 20;
+
+        /**
+         * @brief 解析obj模型
+         * @details 基于string_view与from_chars的零拷贝解析, 不再为每行构造字符串流.
+         *          先预扫描出各对象的范围与v/vt/vn数量以确定全局索引偏移, 再在线程池上并行解析各对象
+         * @param source obj模型源
+         * @param parallel 是否并行解析各对象
+         * @return 以对象名为键的缓冲区组装布局表
+         */
+        static std::map<std::string, VertexLayout<float>> ObjModelLoader(std::string_view source, bool parallel = true);
+
+        /**
+         * @brief 通过二进制网格缓存载入obj模型
+         * @details 缓存有效时直接映射缓存读取; 否则映射源文件解析, 经焊接, VertexGenerator补全法线与切线, MeshOptimizer重排, 细节层级生成与簇划分后在源文件旁写入缓存供下次使用.
+         *          缓存保存重排后的结果, 关闭重排时仍会读取已有的缓存, 但不写入缓存
+         * @param path obj模型路径
+         * @param isOptimize 是否以MeshOptimizer::optimize按顶点缓存重排
+         * @return 以对象名为键的缓冲区组装布局表
+         */
+        static std::map<std::string, VertexLayout<float>> ObjModelCacheLoader(const std::filesystem::path& path, bool isOptimize = true);
+
+        /**
+         * @brief 流式解析obj模型
+         * @details 按固定大小分块读取, 跨块的不完整行会被保留到下一块; 每个o块结束后立即以回调交出该对象.
+         *          峰值内存约为一个分块加上当前对象, 适合无法整体载入内存的大型模型
+         * @param source obj模型输入流
+         * @param callback 对象回调
+         * @param chunkSize 分块大小
+         */
+        static void ObjModelStreamLoader(std::istream& source, const ObjectCallback& callback, size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief 流式解析obj模型文件
+         * @details 他似乎不需要详细注释[划掉]
+         * @param path obj模型路径
+         * @param callback 对象回调
+         * @param chunkSize 分块大小
+         */
+        static void ObjModelStreamLoader(const std::filesystem::path& path, const ObjectCallback& callback, size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief 载入glTF 2.0二进制模型(.glb)
+         * @details 映射文件后直接从访问器的缓冲视图读取, 不经文本解析与索引展开, 结果布局已组装, 无需再次焊接.
+         *          交错且全为float的访问器整块拷贝; 量化的归一化short/ushort访问器以Snorm16/Unorm16存储格式原样保留, 打包上传时位模式不变.
+         *          每个网格图元生成一个对象, 多图元网格以"名称.序号"命名; 缺少的法线与切线由VertexGenerator补全.
+         *          忽略节点变换, 材质与稀疏访问器, 仅支持三角形图元
+         * @param path glb模型路径
+         * @return 以对象名为键的缓冲区组装布局表
+         */
+        static std::map<std::string, VertexLayout<float>> GlbModelLoader(const std::filesystem::path& path);
+
+        /**
+         * @brief 解析obj模型[旧]
+         * @details 基于字符串流的旧解析器, 仅保留用于基准对比
+         * @param source obj模型源
+         * @return 以对象名为键的缓冲区组装布局表
+         */
+        static std::map<std::string, VertexLayout<float>> ObjModelLegacyLoader(const std::string& source);
     private:
         struct VertexCounter {
             size_t count;
             size_t start;
         };
+
+        /**
+         * @brief 预扫描得到的对象范围
+         * @details 各计数器的start为该对象在全局中的索引偏移, count为对象内数量
+         */
+        struct ObjectRange {
+            std::string_view name;
+            std::string_view body;
+            VertexCounter v;
+            VertexCounter t;
+            VertexCounter n;
+            size_t faces;
+        };
+
         class ObjModelLoader {
             public:
                 ~ObjModelLoader() = default;
+                static std::map<std::string, VertexLayout<float>> parser(std::string_view source, bool parallel);
+                static std::vector<ObjectRange> objectScan(std::string_view source);
+                static VertexLayout<float> objectProcess(const ObjectRange& object);
+                static VertexLayout<float> layoutBuild(std::vector<float>&& vertices, std::vector<float>&& texCoord, std::vector<float>&& normal, std::vector<unsigned int>&& indices);
+                static void lineProcess(std::string_view line, std::vector<float>& vertices, std::vector<float>& texCoord, std::vector<float>& normal, std::vector<unsigned int> &indices, VertexCounter& v, VertexCounter& t, VertexCounter& n);
+        };
+        class ObjModelStreamLoader {
+            public:
+                ObjModelStreamLoader(const ObjectCallback& callback): _callback(callback) {}
+                ~ObjModelStreamLoader() = default;
+                void parser(std::istream& source, size_t chunkSize);
+            private:
+                const ObjectCallback& _callback;
+                std::string _name;
+                bool _isOpen{false};
+                std::vector<float> _vertices;
+                std::vector<float> _texCoord;
+                std::vector<float> _normal;
+                std::vector<unsigned int> _indices;
+                VertexCounter _v{0, 0}, _t{0, 0}, _n{0, 0};
+
+                void lineProcess(std::string_view line);
+                void objectEmit();
+        };
+        class GlbModelLoader {
+            public:
+                ~GlbModelLoader() = default;
+                static std::map<std::string, VertexLayout<float>> parser(std::string_view source, const std::filesystem::path& directory);
+        };
+        class ObjModelLegacyLoader {
+            public:
+                ~ObjModelLegacyLoader() = default;
                 static std::map<std::string, VertexLayout<float>> parser(const std::string& source);
                 static void objectProcess(const std::string& name, std::istringstream &source, std::map<std::string, VertexLayout<float>>& models, VertexCounter& v, VertexCounter& t, VertexCounter& n);
                 static void lineProcess(const std::string &line, std::vector<float>& vertices, std::vector<float>& texCoord, std::vector<float>& normal, std::vector<unsigned int> &indices, VertexCounter& v, VertexCounter& t, VertexCounter& n);
         };
-};
\ No newline at end of file
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <map>
+#include <string>
+
+#include <VertexLayout.hpp>
+
+/**
+ * @brief 顶点属性生成
+ * @details 为只有坐标(与纹理坐标)的网格在导入时补全法线与切线, 作用于已焊接的索引网格.
+ *          三角形按区间在线程池上并行求面向量, 再经顶点到三角形的邻接表按顶点并行归约, 不需要原子操作或逐线程累加缓冲;
+ *          支持SSE2时叉乘与累加以4宽向量完成.
+ *          生成的元素追加在现有元素之后, 因此已有元素的location保持不变
+ */
+class VertexGenerator {
+    public:
+        static constexpr size_t rangeSize = 4096;
+
+        /**
+         * @brief 生成面积加权的平滑法线
+         * @details 坐标相同的顶点(纹理接缝处被拆开的顶点)共享同一法线, 以免接缝处出现光照断裂; 退化三角形不参与加权
+         * @param indices 三角形索引
+         * @param indexCount 索引数量
+         * @param positions 第一个顶点的坐标地址
+         * @param vertexCount 顶点数量
+         * @param stride 相邻顶点间隔的浮点数数量
+         * @param normals 输出地址, 每个顶点紧密排列3个浮点
+         */
+        static void computeNormals(const unsigned int* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t stride, float* normals);
+
+        /**
+         * @brief 生成切线
+         * @details 遵循MikkTSpace的约定: 切线对法线正交化后归一化, w为副切线符号, 着色器中以bitangent = w * cross(normal, tangent)重建.
+         *          按面积加权累加, 不像MikkTSpace那样在切线空间不连续处拆分顶点, 因此镜像UV的接缝处结果可能与烘焙工具略有差异
+         * @param indices 三角形索引
+         * @param indexCount 索引数量
+         * @param positions 第一个顶点的坐标地址
+         * @param texCoords 第一个顶点的纹理坐标地址
+         * @param normals 第一个顶点的法线地址
+         * @param vertexCount 顶点数量
+         * @param stride 坐标, 纹理坐标与法线相邻顶点间隔的浮点数数量
+         * @param tangents 输出地址, 每个顶点紧密排列4个浮点
+         */
+        static void computeTangents(const unsigned int* indices, size_t indexCount, const float* positions, const float* texCoords, const float* normals, size_t vertexCount, size_t stride, float* tangents);
+
+        /**
+         * @brief 为布局补全缺失的法线与切线
+         * @details 缺少normal元素时生成法线; 含texCoord而缺少tangent元素时生成切线.
+         *          布局尚未组装时会先进行焊接组装, 补全后以新的交错缓冲区重建布局, 包围体保留
+         * @param layout 缓冲区组装布局
+         * @param isTangent 是否生成切线
+         * @return 是否生成了任何元素
+         */
+        static bool generate(VertexLayout<float>& layout, bool isTangent = true);
+
+        /**
+         * @brief 为布局表中的所有布局补全缺失的法线与切线
+         * @details 对象依次处理, 对象内部按三角形区间并行
+         * @param models 以对象名为键的缓冲区组装布局表
+         * @param isTangent 是否生成切线
+         */
+        static void generate(std::map<std::string, VertexLayout<float>>& models, bool isTangent = true);
+};
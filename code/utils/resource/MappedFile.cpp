@@ -0,0 +1,104 @@
+#include "MappedFile.hpp"
+
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool MappedFile::open(const std::filesystem::path& path) {
+    close();
+    if (map(path)) {
+        _isOpen = true;
+        _isMapped = _size != 0;
+        return true;
+    }
+    return _isOpen = read(path);
+}
+
+void MappedFile::close() {
+    if (_isMapped) {
+        #ifdef _WIN32
+            UnmapViewOfFile(_data);
+        #else
+            munmap(const_cast<char*>(_data), _size);
+        #endif
+    }
+    _data = nullptr;
+    _size = 0;
+    _isOpen = false;
+    _isMapped = false;
+    _fallback.clear();
+    _fallback.shrink_to_fit();
+}
+
+bool MappedFile::map(const std::filesystem::path& path) {
+    #ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+        if (fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return true;
+        }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) return false;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr) return false;
+        _data = static_cast<const char*>(view);
+        _size = static_cast<size_t>(fileSize.QuadPart);
+        return true;
+    #else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        if (info.st_size == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+        posix_madvise(view, static_cast<size_t>(info.st_size), POSIX_MADV_SEQUENTIAL);
+        _data = static_cast<const char*>(view);
+        _size = static_cast<size_t>(info.st_size);
+        return true;
+    #endif
+}
+
+bool MappedFile::read(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    auto end = file.tellg();
+    if (end < 0) return false;
+    _fallback.resize(static_cast<size_t>(end));
+    file.seekg(0);
+    if (!file.read(_fallback.data(), static_cast<std::streamsize>(_fallback.size()))) {
+        _fallback.clear();
+        return false;
+    }
+    _data = _fallback.data();
+    _size = _fallback.size();
+    return true;
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 只读文件映射
+ * @details 优先使用系统内存映射, 文件内容按需分页载入而不进行拷贝; 映射失败时退化为一次性读入内存.
+ *          两种方式对外都表现为一段连续只读内存, 解析器可以直接在其上原地解析. 平台头文件只在MappedFile.cpp中包含
+ */
+class MappedFile {
+    public:
+        MappedFile() = default;
+
+        /**
+         * @brief 映射文件构造
+         * @details 他似乎不需要详细注释[划掉]
+         * @param path 文件路径
+         */
+        explicit MappedFile(const std::filesystem::path& path) {
+            open(path);
+        }
+
+        ~MappedFile() {
+            close();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator = (const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept:
+            _data(std::exchange(other._data, nullptr)),
+            _size(std::exchange(other._size, 0)),
+            _isOpen(std::exchange(other._isOpen, false)),
+            _isMapped(std::exchange(other._isMapped, false)),
+            _fallback(std::move(other._fallback)) {}
+
+        MappedFile& operator = (MappedFile&& other) noexcept {
+            if (this != &other) {
+                close();
+                _data = std::exchange(other._data, nullptr);
+                _size = std::exchange(other._size, 0);
+                _isOpen = std::exchange(other._isOpen, false);
+                _isMapped = std::exchange(other._isMapped, false);
+                _fallback = std::move(other._fallback);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief 打开并映射文件
+         * @details 先尝试系统内存映射, 失败后退化为读入内存
+         * @param path 文件路径
+         * @return 是否成功打开
+         */
+        bool open(const std::filesystem::path& path);
+
+        /**
+         * @brief 关闭映射
+         * @details 他似乎不需要详细注释[划掉]
+         */
+        void close();
+
+        [[nodiscard]] bool isOpen() const {
+            return _isOpen;
+        }
+
+        /**
+         * @brief 是否为系统内存映射
+         * @details 为false时数据来自退化路径的内存拷贝
+         * @return 他似乎不需要注释[划掉]
+         */
+        [[nodiscard]] bool isMapped() const {
+            return _isMapped;
+        }
+
+        [[nodiscard]] const char* data() const {
+            return _data;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return _size == 0;
+        }
+
+        /**
+         * @brief 获取文件内容视图
+         * @details 视图生命周期不得超过映射本身
+         * @return 文件内容视图
+         */
+        [[nodiscard]] std::string_view view() const {
+            return {_data, _size};
+        }
+
+        /**
+         * @brief 通过类型转换操作符获取文件内容视图
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 文件内容视图
+         */
+        operator std::string_view() const {
+            return view();
+        }
+
+    private:
+        const char* _data{nullptr};
+        size_t _size{0};
+        bool _isOpen{false};
+        bool _isMapped{false};
+        std::vector<char> _fallback;
+
+        /**
+         * @brief 系统内存映射
+         * @details 映射建立后文件句柄即可关闭, 映射视图独立存活
+         * @param path 文件路径
+         * @return 是否成功
+         */
+        bool map(const std::filesystem::path& path);
+
+        /**
+         * @brief 退化路径: 读入内存
+         * @details 他似乎不需要详细注释[划掉]
+         * @param path 文件路径
+         * @return 是否成功
+         */
+        bool read(const std::filesystem::path& path);
+};
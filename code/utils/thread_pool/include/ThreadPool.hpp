@@ -0,0 +1,185 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief 线程池
+ * @details 固定数量的工作线程从同一任务队列中取任务执行
+ */
+class ThreadPool {
+    public:
+        /**
+         * @brief 线程池构造
+         * @details 他似乎不需要详细注释[划掉]
+         * @param threadCount 工作线程数量, 为0时使用硬件并发数
+         */
+        explicit ThreadPool(size_t threadCount = 0) {
+            if (threadCount == 0) {
+                threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+            }
+            _workers.reserve(threadCount);
+            for (size_t i = 0; i < threadCount; i++) {
+                _workers.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        /**
+         * @brief 析构
+         * @details 执行完队列中剩余任务后回收所有工作线程
+         */
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(_mtx);
+                _isStop = true;
+            }
+            _cv.notify_all();
+            for (auto& worker : _workers) {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator = (const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator = (ThreadPool&&) = delete;
+
+        /**
+         * @brief 获取进程共享线程池
+         * @details 首次调用时才创建工作线程
+         * @return 线程池引用
+         */
+        static ThreadPool& shared() {
+            static ThreadPool pool{};
+            return pool;
+        }
+
+        /**
+         * @brief 提交任务
+         * @details 他似乎不需要详细注释[划掉]
+         * @tparam Func 任务类型
+         * @param func 任务
+         * @return 任务结果
+         */
+        template<typename Func>
+        auto submit(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>> {
+            using ResultType = std::invoke_result_t<std::decay_t<Func>>;
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<Func>(func));
+            std::future<ResultType> result = task->get_future();
+            {
+                std::lock_guard lock(_mtx);
+                _tasks.emplace([task] { (*task)(); });
+            }
+            _cv.notify_one();
+            return result;
+        }
+
+        /**
+         * @brief 并行执行[0, count)区间
+         * @details 调用线程同样参与执行, 因此即使在池内任务中嵌套调用, 或池中线程全部繁忙, 也不会死锁.
+         *          任意一次调用抛出的首个异常会在调用线程上重新抛出
+         * @tparam Func 任务类型, 签名为void(size_t)
+         * @param count 区间长度
+         * @param func 任务
+         */
+        template<typename Func>
+        void parallelFor(size_t count, Func&& func) {
+            if (count == 0) return;
+            if (count == 1 || _workers.size() == 1) {
+                for (size_t i = 0; i < count; i++) {
+                    func(i);
+                }
+                return;
+            }
+
+            auto state = std::make_shared<ParallelState>();
+            state->count = count;
+            state->func = [&func](size_t i) { func(i); };
+
+            size_t helperCount = (std::min)(count - 1, _workers.size());
+            {
+                std::lock_guard lock(_mtx);
+                for (size_t i = 0; i < helperCount; i++) {
+                    _tasks.emplace([state] { state->run(); });
+                }
+            }
+            _cv.notify_all();
+
+            state->run();
+            std::unique_lock lock(state->mtx);
+            state->cv.wait(lock, [&state] { return state->active.load() == 0; });
+            if (state->error) {
+                std::rethrow_exception(state->error);
+            }
+        }
+
+        /**
+         * @brief 获取工作线程数量
+         * @details 他似乎不需要详细注释[划掉]
+         * @return 工作线程数量
+         */
+        [[nodiscard]] size_t size() const {
+            return _workers.size();
+        }
+
+    private:
+        /**
+         * @brief 并行区间共享状态
+         * @details 由调用线程与辅助任务共同持有, 晚到的辅助任务只会看到区间已耗尽并直接返回
+         */
+        struct ParallelState {
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> active{0};
+            size_t count{};
+            std::function<void(size_t)> func;
+            std::exception_ptr error;
+            std::mutex mtx;
+            std::condition_variable cv;
+
+            void run() {
+                active++;
+                size_t i;
+                while ((i = next++) < count) {
+                    try {
+                        func(i);
+                    } catch (...) {
+                        std::lock_guard lock(mtx);
+                        if (!error) error = std::current_exception();
+                    }
+                }
+                if (--active == 0) {
+                    std::lock_guard lock(mtx);
+                    cv.notify_all();
+                }
+            }
+        };
+
+        std::vector<std::thread> _workers;
+        std::queue<std::function<void()>> _tasks;
+        std::mutex _mtx;
+        std::condition_variable _cv;
+        bool _isStop{false};
+
+        void workerLoop() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(_mtx);
+                    _cv.wait(lock, [this] { return _isStop || !_tasks.empty(); });
+                    if (_isStop && _tasks.empty()) return;
+                    task = std::move(_tasks.front());
+                    _tasks.pop();
+                }
+                task();
+            }
+        }
+};
@@ -2,10 +2,10 @@
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+// 与GeometryStore::transformLocation一致, 合并提交时为实例属性, 否则为常量属性
+layout (location = 12) in mat4 Transform;
 out vec2 TexCoord;
 
-uniform mat4 Transform;
-
 void main() {
     gl_Position = Transform * vec4(aPos.xyz, 1.0f);
     TexCoord = aTexCoord;